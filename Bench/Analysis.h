@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    Analysis.h
+    Created: 20 Oct 2026 9:12:40am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+// Spectrum and timing helpers for the benchmarks.  Nothing here is fast, it only
+// has to be right.
+namespace Analysis {
+    // In place radix-2 FFT, the size has to be a power of two
+    inline void fft(std::vector<std::complex<double>>& a) {
+        const size_t n = a.size();
+        for (size_t i = 1, j = 0; i < n; ++i) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(a[i], a[j]);
+            }
+        }
+        for (size_t length = 2; length <= n; length <<= 1) {
+            const double angle = -2.0 * M_PI / double(length);
+            const std::complex<double> step(std::cos(angle), std::sin(angle));
+            for (size_t i = 0; i < n; i += length) {
+                std::complex<double> w(1.0);
+                for (size_t j = 0; j < length / 2; ++j) {
+                    auto u = a[i + j];
+                    auto v = a[i + j + length / 2] * w;
+                    a[i + j] = u + v;
+                    a[i + j + length / 2] = u - v;
+                    w *= step;
+                }
+            }
+        }
+    }
+
+    // Power in each bin up to Nyquist, with a 4-term Blackman-Harris window (-92dB sidelobes)
+    inline std::vector<double> powerSpectrum(const std::vector<float>& x) {
+        const size_t n = x.size();
+        std::vector<std::complex<double>> a(n);
+        for (size_t i = 0; i < n; ++i) {
+            const double t = 2.0 * M_PI * double(i) / double(n - 1);
+            const double window = 0.35875 - 0.48829 * std::cos(t) + 0.14128 * std::cos(2.0 * t) - 0.01168 * std::cos(3.0 * t);
+            a[i] = window * double(x[i]);
+        }
+        fft(a);
+        std::vector<double> power(n / 2);
+        for (size_t k = 0; k < n / 2; ++k) {
+            power[k] = std::norm(a[k]);
+        }
+        return power;
+    }
+
+    // Energy that isn't on a harmonic of f0 (aliasing and noise) relative to the energy
+    // that is, in dB.  Only the bins between 20 Hz and maxFrequency count, so the
+    // leaky integrator's DC and anything above the audible band are left out
+    inline double aliasDb(const std::vector<float>& x, double f0, double sampleRate, double maxFrequency) {
+        const auto power = powerSpectrum(x);
+        const double binWidth = sampleRate / double(x.size());
+        double harmonics = 0.0;
+        double other = 0.0;
+        for (size_t k = 0; k < power.size(); ++k) {
+            const double f = double(k) * binWidth;
+            if (f < 20.0 || f > maxFrequency) {
+                continue;
+            }
+            // The window's main lobe is 4 bins either side
+            const double distance = std::abs(f / f0 - std::round(f / f0)) * f0;
+            if (distance < 6.0 * binWidth) {
+                harmonics += power[k];
+            } else {
+                other += power[k];
+            }
+        }
+        return 10.0 * std::log10(other / harmonics);
+    }
+
+    // Amplitude of the sinusoid at frequency f, by correlating with a Hann window
+    inline double toneLevel(const std::vector<float>& x, double f, double sampleRate) {
+        std::complex<double> sum = 0.0;
+        const size_t n = x.size();
+        for (size_t i = 0; i < n; ++i) {
+            const double window = 0.5 - 0.5 * std::cos(2.0 * M_PI * double(i) / double(n - 1));
+            sum += window * double(x[i]) * std::polar(1.0, -2.0 * M_PI * f * double(i) / sampleRate);
+        }
+        // The Hann window has a gain of 1/2
+        return 4.0 * std::abs(sum) / double(n);
+    }
+
+    inline double rms(const std::vector<float>& x) {
+        double sum = 0.0;
+        for (float s : x) {
+            sum += double(s) * double(s);
+        }
+        return std::sqrt(sum / double(x.size()));
+    }
+
+    inline double toDb(double gain) {
+        return 20.0 * std::log10(gain);
+    }
+
+    // Runs work a few times and returns the quickest, in nanoseconds per unit (work
+    // does `units` of whatever is being measured).  The quickest run is the one the
+    // rest of the machine got in the way of the least
+    template<typename Work>
+    double nanoseconds(Work work, double units, int runs = 5) {
+        double best = 1e300;
+        for (int run = 0; run < runs; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            work();
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+        }
+        return best / units;
+    }
+
+    // Stops the compiler from throwing away a result that's only used for timing
+    inline volatile float sink = 0.0f;
+    inline void keep(float value) {
+        sink = value;
+    }
+}
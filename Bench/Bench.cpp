@@ -0,0 +1,28 @@
+/*
+  ==============================================================================
+
+    Bench.cpp
+    Created: 20 Oct 2026 9:10:18am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+// Measures the cost and the quality of the DSP code that builds without JUCE.
+// `make results` in this folder runs it and writes Results.txt, which is checked
+// in so the numbers quoted in the commit messages can be compared against a run
+// on another machine.
+
+#include "Bench.h"
+
+int main() {
+    benchResampler();
+    benchOscillators();
+    benchSharedResources();
+    benchFilters();
+    benchNoise();
+    benchModulation();
+    benchInstantiation();
+    benchEditor();
+    return 0;
+}
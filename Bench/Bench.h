@@ -0,0 +1,21 @@
+/*
+  ==============================================================================
+
+    Bench.h
+    Created: 20 Oct 2026 9:10:18am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// One of these per benchmark, each prints its own tables to stdout
+void benchResampler();
+void benchOscillators();
+void benchSharedResources();
+void benchFilters();
+void benchNoise();
+void benchModulation();
+void benchInstantiation();
+void benchEditor();
@@ -0,0 +1,370 @@
+/*
+  ==============================================================================
+
+    BenchEditor.cpp
+    Created: 20 Oct 2026 4:12:50pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "Bench.h"
+#include "Analysis.h"
+
+// There's no JUCE here, so the knob is drawn with a small scanline rasteriser that
+// works the way JUCE's software renderer does: paths are flattened to polygons and
+// filled with anti-aliasing, images are composited one pixel to one pixel.  It draws
+// the same shapes as LookAndFeel::drawRotarySlider, at the editor's knob size.  The
+// text (the label and the value box) isn't drawn, so these are the parts the
+// background cache changed and not the whole repaint
+namespace {
+    struct Point {
+        float x, y;
+    };
+
+    // Premultiplied ARGB, like juce::Image::ARGB
+    constexpr uint32_t argb(uint32_t a, uint32_t r, uint32_t g, uint32_t b) {
+        return (a << 24) | (r << 16) | (g << 8) | b;
+    }
+
+    // Source over destination, the source scaled by coverage (0 to 256)
+    inline uint32_t blend(uint32_t dst, uint32_t src, uint32_t coverage) {
+        const uint32_t srcRB = (((src & 0x00FF00FFu) * coverage) >> 8) & 0x00FF00FFu;
+        const uint32_t srcAG = (((src >> 8) & 0x00FF00FFu) * coverage) & 0xFF00FF00u;
+        const uint32_t s = srcRB | srcAG;
+        const uint32_t inverse = 256u - (s >> 24);
+        const uint32_t dstRB = (((dst & 0x00FF00FFu) * inverse) >> 8) & 0x00FF00FFu;
+        const uint32_t dstAG = (((dst >> 8) & 0x00FF00FFu) * inverse) & 0xFF00FF00u;
+        return s + (dstRB | dstAG);
+    }
+
+    class Canvas {
+        public:
+            Canvas(int width_, int height_, float scale_)
+                : width(width_), height(height_), scale(scale_), pixels(size_t(width * height), 0u),
+                  coverage(size_t(width + 2), 0.0f) {}
+
+            // In logical coordinates, like juce::Graphics
+            void fillRect(float x, float y, float w, float h, uint32_t colour) {
+                const int x0 = std::max(0, int(x * scale)), x1 = std::min(width, int(std::ceil((x + w) * scale)));
+                const int y0 = std::max(0, int(y * scale)), y1 = std::min(height, int(std::ceil((y + h) * scale)));
+                for (int row = y0; row < y1; ++row) {
+                    std::fill(&pixels[size_t(row * width + x0)], &pixels[size_t(row * width + x1)], colour);
+                }
+            }
+
+            // Non-zero winding, four sub-scanlines per pixel and exact coverage across
+            void fillPolygon(const std::vector<Point>& logical, uint32_t colour) {
+                constexpr int SUBSAMPLES = 4;
+                points.resize(logical.size());
+                float top = 1e30f, bottom = -1e30f;
+                for (size_t i = 0; i < logical.size(); ++i) {
+                    points[i] = { logical[i].x * scale, logical[i].y * scale };
+                    top = std::min(top, points[i].y);
+                    bottom = std::max(bottom, points[i].y);
+                }
+                const int firstRow = std::max(0, int(top)), lastRow = std::min(height - 1, int(bottom));
+                for (int row = firstRow; row <= lastRow; ++row) {
+                    int left = width, right = 0;
+                    for (int sub = 0; sub < SUBSAMPLES; ++sub) {
+                        const float y = float(row) + (float(sub) + 0.5f) / float(SUBSAMPLES);
+                        crossings.clear();
+                        for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++) {
+                            const Point& a = points[j];
+                            const Point& b = points[i];
+                            if ((a.y <= y) != (b.y <= y)) {
+                                const float x = a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+                                crossings.push_back({ x, b.y > a.y ? 1.0f : -1.0f });
+                            }
+                        }
+                        std::sort(crossings.begin(), crossings.end(), [](const Point& a, const Point& b) { return a.x < b.x; });
+                        float winding = 0.0f;
+                        for (size_t i = 0; i + 1 < crossings.size(); ++i) {
+                            winding += crossings[i].y;
+                            if (winding != 0.0f) {
+                                const float x0 = std::clamp(crossings[i].x, 0.0f, float(width));
+                                const float x1 = std::clamp(crossings[i + 1].x, 0.0f, float(width));
+                                addSpan(x0, x1, 1.0f / float(SUBSAMPLES));
+                                left = std::min(left, int(x0));
+                                right = std::max(right, int(x1) + 1);
+                            }
+                        }
+                    }
+                    uint32_t* line = &pixels[size_t(row * width)];
+                    for (int x = left; x < std::min(right, width); ++x) {
+                        const uint32_t amount = uint32_t(std::min(coverage[size_t(x)], 1.0f) * 256.0f);
+                        if (amount != 0) {
+                            line[x] = blend(line[x], colour, amount);
+                        }
+                        coverage[size_t(x)] = 0.0f;
+                    }
+                    if (right >= width) {
+                        coverage[size_t(width)] = 0.0f;
+                    }
+                }
+            }
+
+            // One to one, the image is already at the physical resolution
+            void drawImage(const Canvas& image, float x, float y) {
+                const int x0 = int(x * scale), y0 = int(y * scale);
+                for (int row = 0; row < image.height && y0 + row < height; ++row) {
+                    const uint32_t* src = &image.pixels[size_t(row * image.width)];
+                    uint32_t* dst = &pixels[size_t((y0 + row) * width + x0)];
+                    for (int col = 0; col < image.width && x0 + col < width; ++col) {
+                        if (src[col] != 0) {
+                            dst[col] = blend(dst[col], src[col], 256u);
+                        }
+                    }
+                }
+            }
+
+            float getScale() const noexcept { return scale; }
+            uint32_t pixel(int x, int y) const { return pixels[size_t(y * width + x)]; }
+
+        private:
+            int width, height;
+            float scale;
+            std::vector<uint32_t> pixels;
+            std::vector<float> coverage;
+            std::vector<Point> points;
+            // x and the edge's direction
+            std::vector<Point> crossings;
+
+            void addSpan(float x0, float x1, float amount) {
+                const int i0 = int(x0), i1 = int(x1);
+                if (i0 == i1) {
+                    coverage[size_t(i0)] += (x1 - x0) * amount;
+                    return;
+                }
+                coverage[size_t(i0)] += (float(i0 + 1) - x0) * amount;
+                for (int i = i0 + 1; i < i1; ++i) {
+                    coverage[size_t(i)] += amount;
+                }
+                coverage[size_t(i1)] += (x1 - float(i1)) * amount;
+            }
+    };
+
+    // Segments for an arc so it's within a quarter of a physical pixel, like a
+    // flattened juce::Path
+    int arcSegments(float radius, float angle, float scale) {
+        const float tolerance = 0.25f / (radius * scale);
+        const float step = 2.0f * std::acos(std::max(0.0f, 1.0f - tolerance));
+        return std::max(2, int(std::ceil(std::abs(angle) / step)));
+    }
+
+    // PathStrokeType::curved with butt ends: the outer edge and then the inner one back.
+    // The angles are clockwise from 12 o'clock, like addCentredArc
+    void strokeArc(Canvas& canvas, std::vector<Point>& polygon, Point center, float radius, float lineWidth,
+                   float fromAngle, float toAngle, uint32_t colour) {
+        const int segments = arcSegments(radius + lineWidth / 2.0f, toAngle - fromAngle, canvas.getScale());
+        polygon.clear();
+        for (int side = 0; side < 2; ++side) {
+            const float r = side == 0 ? radius + lineWidth / 2.0f : radius - lineWidth / 2.0f;
+            for (int i = 0; i <= segments; ++i) {
+                const int step = side == 0 ? i : segments - i;
+                const float angle = fromAngle + (toAngle - fromAngle) * float(step) / float(segments);
+                polygon.push_back({ center.x + r * std::sin(angle), center.y - r * std::cos(angle) });
+            }
+        }
+        canvas.fillPolygon(polygon, colour);
+    }
+
+    void drawLine(Canvas& canvas, std::vector<Point>& polygon, Point a, Point b, float lineWidth, uint32_t colour) {
+        const float length = std::hypot(b.x - a.x, b.y - a.y);
+        const float nx = -(b.y - a.y) / length * lineWidth / 2.0f, ny = (b.x - a.x) / length * lineWidth / 2.0f;
+        polygon.assign({ { a.x + nx, a.y + ny }, { b.x + nx, b.y + ny }, { b.x - nx, b.y - ny }, { a.x - nx, a.y - ny } });
+        canvas.fillPolygon(polygon, colour);
+    }
+
+    void fillCircle(Canvas& canvas, std::vector<Point>& polygon, Point center, float diameter, uint32_t colour) {
+        const float radius = diameter / 2.0f;
+        const int segments = arcSegments(radius, 2.0f * float(M_PI), canvas.getScale());
+        polygon.clear();
+        for (int i = 0; i < segments; ++i) {
+            const float angle = 2.0f * float(M_PI) * float(i) / float(segments);
+            polygon.push_back({ center.x + radius * std::sin(angle), center.y - radius * std::cos(angle) });
+        }
+        canvas.fillPolygon(polygon, colour);
+    }
+
+    // The editor's knobs: RotaryKnob is 80 x 110, the slider inside it is 78 x 94 and
+    // the rotary part (above the text box) is 78 x 74
+    constexpr int KNOBS = 25;
+    constexpr float SLIDER_WIDTH = 78.0f, SLIDER_HEIGHT = 94.0f, ROTARY_HEIGHT = 74.0f;
+    constexpr float START_ANGLE = float(M_PI) * 1.25f, END_ANGLE = float(M_PI) * 2.75f;
+    constexpr float LINE_WIDTH = 6.0f;
+    // LookAndFeel's colours
+    constexpr uint32_t BACKGROUND = argb(255, 30, 60, 90);
+    constexpr uint32_t OUTLINE = argb(255, 0, 0, 0);
+    constexpr uint32_t FILL = argb(255, 90, 180, 240);
+    constexpr uint32_t THUMB = argb(255, 255, 255, 255);
+
+    // knobBounds() in LookAndFeel.cpp
+    Point knobCenter(float width) {
+        return { width / 2.0f, (width - 8.0f) / 2.0f };
+    }
+
+    float arcRadius(float width) {
+        return (width - 32.0f) / 2.0f - LINE_WIDTH / 2.0f;
+    }
+
+    // The value arc and the dial, which both versions draw every time
+    void drawValue(Canvas& canvas, std::vector<Point>& polygon, float sliderPos) {
+        const Point center = knobCenter(SLIDER_WIDTH);
+        const float radius = arcRadius(SLIDER_WIDTH);
+        const float toAngle = START_ANGLE + sliderPos * (END_ANGLE - START_ANGLE);
+        strokeArc(canvas, polygon, center, radius, LINE_WIDTH, START_ANGLE, toAngle, FILL);
+        const float dialRadius = radius - 6.0f;
+        const Point thumb { center.x + dialRadius * std::sin(toAngle), center.y - dialRadius * std::cos(toAngle) };
+        drawLine(canvas, polygon, center, thumb, 3.0f, THUMB);
+        fillCircle(canvas, polygon, thumb, 3.0f, THUMB);
+        fillCircle(canvas, polygon, center, 3.0f, THUMB);
+    }
+
+    // Before: the slider wasn't opaque, so the editor and the RotaryKnob filled the area
+    // behind it first, and the background arc was stroked every time
+    void paintBefore(Canvas& canvas, std::vector<Point>& polygon, float sliderPos) {
+        canvas.fillRect(0.0f, 0.0f, SLIDER_WIDTH, SLIDER_HEIGHT, BACKGROUND);
+        canvas.fillRect(0.0f, 0.0f, SLIDER_WIDTH, SLIDER_HEIGHT, BACKGROUND);
+        strokeArc(canvas, polygon, knobCenter(SLIDER_WIDTH), arcRadius(SLIDER_WIDTH), LINE_WIDTH,
+                  START_ANGLE, END_ANGLE, OUTLINE);
+        drawValue(canvas, polygon, sliderPos);
+    }
+
+    // Now: the slider fills its own background and the arc comes from the cached image
+    void paintNow(Canvas& canvas, const Canvas& background, std::vector<Point>& polygon, float sliderPos) {
+        canvas.fillRect(0.0f, 0.0f, SLIDER_WIDTH, SLIDER_HEIGHT, BACKGROUND);
+        canvas.drawImage(background, 0.0f, 0.0f);
+        drawValue(canvas, polygon, sliderPos);
+    }
+
+    Canvas knobBackground(float scale) {
+        const int size = int(std::ceil(SLIDER_WIDTH * scale));
+        Canvas image(size, size, scale);
+        std::vector<Point> polygon;
+        strokeArc(image, polygon, knobCenter(SLIDER_WIDTH), arcRadius(SLIDER_WIDTH), LINE_WIDTH,
+                  START_ANGLE, END_ANGLE, OUTLINE);
+        return image;
+    }
+
+    // The editor's attachments: 25 knobs, 10 choices and 2 toggles
+    constexpr int ATTACHMENTS = 37;
+
+    // What ParameterAttachments::timerCallback does when the host automates every
+    // parameter: each value has moved since the last refresh, so every control is
+    // updated and every knob repaints.  The choices and toggles are only polled, their
+    // text isn't drawn here
+    struct Attachments {
+        std::atomic<float> values[ATTACHMENTS];
+        float shownValues[ATTACHMENTS];
+        float sliderPos[KNOBS];
+
+        Attachments() {
+            for (int i = 0; i < ATTACHMENTS; ++i) {
+                values[i] = 0.0f;
+                shownValues[i] = 0.0f;
+            }
+        }
+
+        // The audio thread's side, a new value for everything
+        void automate(int refresh) {
+            for (int i = 0; i < ATTACHMENTS; ++i) {
+                values[i].store(float((refresh + i) % 100) / 99.0f, std::memory_order_relaxed);
+            }
+        }
+
+        int poll() {
+            int updateCount = 0;
+            for (int i = 0; i < ATTACHMENTS; ++i) {
+                const float value = values[i].load(std::memory_order_relaxed);
+                if (value != shownValues[i]) {
+                    shownValues[i] = value;
+                    if (i < KNOBS) {
+                        sliderPos[i] = value;
+                    }
+                    ++updateCount;
+                }
+            }
+            return updateCount;
+        }
+    };
+
+    void automation() {
+        constexpr int REFRESH_RATE = 30;
+        constexpr int REFRESHES = 200;
+        std::printf("Every parameter automated: each refresh polls %d attachments and repaints the\n", ATTACHMENTS);
+        std::printf("%d knobs (with the cached backgrounds).  UI thread time per second, at the\n", KNOBS);
+        std::printf("attachments' %d Hz and if every 60 Hz display frame repainted them\n", REFRESH_RATE);
+        std::printf("  display scale  poll      refresh     %d Hz              60 Hz\n", REFRESH_RATE);
+        for (float scale : { 1.0f, 2.0f }) {
+            Canvas canvas(int(std::ceil(SLIDER_WIDTH * scale)), int(std::ceil(SLIDER_HEIGHT * scale)), scale);
+            const Canvas background = knobBackground(scale);
+            std::vector<Point> polygon;
+            Attachments attachments;
+            int updates = 0;
+            const double poll = Analysis::nanoseconds([&]() {
+                for (int r = 0; r < REFRESHES; ++r) {
+                    attachments.automate(r);
+                    updates += attachments.poll();
+                }
+            }, REFRESHES);
+            const double refresh = Analysis::nanoseconds([&]() {
+                for (int r = 0; r < REFRESHES; ++r) {
+                    attachments.automate(r);
+                    updates += attachments.poll();
+                    for (int knob = 0; knob < KNOBS; ++knob) {
+                        paintNow(canvas, background, polygon, attachments.sliderPos[knob]);
+                    }
+                }
+                Analysis::keep(float(canvas.pixel(0, 0)));
+            }, REFRESHES);
+            Analysis::keep(float(updates));
+            const double perSecond = refresh * REFRESH_RATE / 1e6;
+            std::printf("  %.0fx             %5.2f us  %5.2f ms    %5.1f ms/s (%.1f%%)  %5.1f ms/s (%.1f%%)\n", scale,
+                        poll / 1000.0, refresh / 1e6, perSecond, perSecond / 10.0, 2.0 * perSecond, 2.0 * perSecond / 10.0);
+        }
+        std::printf("\n");
+    }
+}
+
+void benchEditor() {
+    std::printf("== Knob painting (LookAndFeel.cpp, RotaryKnob.cpp)\n\n");
+    std::printf("drawRotarySlider's shapes on a %.0f x %.0f slider, drawn by a scanline rasteriser\n",
+                SLIDER_WIDTH, SLIDER_HEIGHT);
+    std::printf("standing in for JUCE's software renderer (no text).  Before strokes the background\n");
+    std::printf("arc and fills the area behind the slider twice, now blits the cached arc\n");
+    std::printf("  display scale  background   before      now         frame of %d knobs\n", KNOBS);
+    constexpr int PAINTS = 2000;
+    for (float scale : { 1.0f, 2.0f }) {
+        Canvas canvas(int(std::ceil(SLIDER_WIDTH * scale)), int(std::ceil(SLIDER_HEIGHT * scale)), scale);
+        std::vector<Point> polygon;
+        const double build = Analysis::nanoseconds([&]() {
+            const Canvas image = knobBackground(scale);
+            Analysis::keep(float(image.pixel(0, 0)));
+        }, 1.0);
+        const Canvas background = knobBackground(scale);
+        const double before = Analysis::nanoseconds([&]() {
+            for (int i = 0; i < PAINTS; ++i) {
+                paintBefore(canvas, polygon, float(i % 100) / 99.0f);
+            }
+            Analysis::keep(float(canvas.pixel(0, 0)));
+        }, PAINTS);
+        const double now = Analysis::nanoseconds([&]() {
+            for (int i = 0; i < PAINTS; ++i) {
+                paintNow(canvas, background, polygon, float(i % 100) / 99.0f);
+            }
+            Analysis::keep(float(canvas.pixel(0, 0)));
+        }, PAINTS);
+        std::printf("  %.0fx             %5.1f us     %5.1f us    %5.1f us    %.2f ms -> %.2f ms\n", scale,
+                    build / 1000.0, before / 1000.0, now / 1000.0, before * KNOBS / 1e6, now * KNOBS / 1e6);
+    }
+    std::printf("\n");
+
+    automation();
+}
@@ -0,0 +1,237 @@
+/*
+  ==============================================================================
+
+    BenchFilters.cpp
+    Created: 20 Oct 2026 2:41:09pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "Bench.h"
+#include "Analysis.h"
+#include "VoiceRunner.h"
+#include "../Source/FilterCoefficientTable.h"
+
+namespace {
+    constexpr float SAMPLE_RATE = 48000.0f;
+    constexpr int FILTERS = 8;
+
+    // The cutoff the table's g stands for
+    double cutoffFromG(double g, double sampleRate) {
+        return std::atan(g) * sampleRate / M_PI;
+    }
+
+    // The table against the exact formulas, over the cutoffs a voice can ask for and the
+    // Q range the Reso parameter covers (1 to e^3)
+    void coefficientTableAccuracy() {
+        std::printf("Filter coefficient table against the exact formulas, cutoff 30 Hz - 20 kHz,\n");
+        std::printf("Q 1 - 20\n");
+        std::printf("  rate       cutoff below 0.4 fs  cutoff to 20 kHz  a1\n");
+        for (float sampleRate : { 44100.0f, 48000.0f, 96000.0f, 192000.0f }) {
+            FilterCoefficientTable table;
+            table.build(sampleRate);
+            double centsLow = 0.0, centsHigh = 0.0, a1Error = 0.0;
+            for (double log2Cutoff = std::log2(30.0); log2Cutoff <= std::log2(20000.0); log2Cutoff += 1.0 / 97.0) {
+                const double cutoff = std::exp2(log2Cutoff);
+                for (double log2Q = 0.0; log2Q <= 3.0 / std::log(2.0); log2Q += 1.0 / 13.0) {
+                    float g, a1;
+                    table.lookup(float(log2Cutoff), float(log2Q), g, a1);
+                    const double exactG = std::tan(M_PI * cutoff / double(sampleRate));
+                    const double exactA1 = 1.0 / (1.0 + exactG * (exactG + 1.0 / std::exp2(log2Q)));
+                    const double cents = std::abs(1200.0 * std::log2(cutoffFromG(double(g), double(sampleRate)) / cutoff));
+                    if (cutoff < 0.4 * double(sampleRate)) {
+                        centsLow = std::max(centsLow, cents);
+                    }
+                    centsHigh = std::max(centsHigh, cents);
+                    a1Error = std::max(a1Error, std::abs(double(a1) / exactA1 - 1.0));
+                }
+            }
+            std::printf("  %5.1f kHz  %5.2f cents          %5.2f cents       %.3f%%\n",
+                        double(sampleRate) / 1000.0, centsLow, centsHigh, 100.0 * a1Error);
+        }
+        // Worked out the same way build() sizes them
+        const int rows = int(std::ceil((std::log2(FilterCoefficientTable::MAX_CUTOFF) - std::log2(FilterCoefficientTable::MIN_CUTOFF)) *
+                                       FilterCoefficientTable::CUTOFF_STEPS_PER_OCTAVE)) + 2;
+        const int columns = int(std::ceil((std::log2(FilterCoefficientTable::MAX_Q) - std::log2(FilterCoefficientTable::MIN_Q)) *
+                                          FilterCoefficientTable::Q_STEPS_PER_OCTAVE)) + 2;
+        std::printf("Table: %d x %d for a1 and %d for g, %.1f KB\n\n", rows, columns, rows,
+                    double((rows * columns + rows) * int(sizeof(float))) / 1024.0);
+    }
+
+    // What Voice::updateLFO spends on the coefficients, for each of 8 voices' filters on
+    // every update.  Each update is followed by one sample through the filter, or the
+    // compiler would skip all but the last one, so a sample on its own is timed too
+    void coefficientUpdateCost() {
+        constexpr int UPDATES = 20000;
+        FilterCoefficientTable table;
+        table.build(SAMPLE_RATE);
+        Filter filters[FILTERS] {};
+        std::vector<float> cutoffs(UPDATES), log2Cutoffs(UPDATES);
+        for (int i = 0; i < UPDATES; ++i) {
+            cutoffs[size_t(i)] = 200.0f * std::pow(2.0f, 6.0f * float(i % 997) / 997.0f);
+            log2Cutoffs[size_t(i)] = std::log2(cutoffs[size_t(i)]);
+        }
+        const float Q = 2.0f;
+        for (auto& filter : filters) {
+            filter.reset();
+            filter.sampleRate = SAMPLE_RATE;
+            filter.updateCoefficients(cutoffs[0], Q);
+        }
+        const float log2Q = std::log2(Q);
+        const float k = 1.0f / Q;
+        auto run = [&](auto update) {
+            return Analysis::nanoseconds([&]() {
+                float sum = 0.0f;
+                for (int i = 0; i < UPDATES; ++i) {
+                    for (int f = 0; f < FILTERS; ++f) {
+                        update(filters[f], i, f);
+                        sum += filters[f].render(0.1f);
+                    }
+                }
+                Analysis::keep(sum);
+            }, double(UPDATES * FILTERS));
+        };
+        const double sample = run([](Filter&, int, int) {});
+        const double exact = run([&](Filter& filter, int i, int f) {
+            filter.updateCoefficients(cutoffs[size_t(i)] + float(f), Q);
+        });
+        const double tabled = run([&](Filter& filter, int i, int f) {
+            filter.updateCoefficients(table, log2Cutoffs[size_t(i)] + 0.001f * float(f), log2Q, k);
+        });
+        std::printf("SVF coefficient update and one sample, per voice\n");
+        std::printf("  exact %.1f ns, table %.1f ns, the sample alone %.1f ns\n\n", exact, tabled, sample);
+    }
+
+    // Each filter model on its own, 8 of them at different cutoffs, fed a 220 Hz saw at
+    // 0.5 so the drive has something to saturate
+    void filterModelCost() {
+        constexpr int SAMPLES = 48000;
+        constexpr int UPDATES = 20000;
+        const char* const names[] = { "SVF LP", "SVF BP", "SVF HP", "Ladder", "Ladder Drive" };
+        std::vector<float> input(SAMPLES);
+        for (int i = 0; i < SAMPLES; ++i) {
+            const float phase = float(i) * 220.0f / SAMPLE_RATE;
+            input[size_t(i)] = phase - std::floor(phase) - 0.5f;
+        }
+        std::vector<float> cutoffs(UPDATES);
+        for (int i = 0; i < UPDATES; ++i) {
+            cutoffs[size_t(i)] = 200.0f * std::pow(2.0f, 6.0f * float(i % 997) / 997.0f);
+        }
+        const float Q = 4.0f;
+        std::printf("Filter models, per voice (8 voices), Q 4\n");
+        std::printf("  model          render per sample   exact update and one sample\n");
+        for (int type = FILTER_SVF_LP; type <= FILTER_LADDER_DRIVE; ++type) {
+            Filter svfs[FILTERS] {};
+            LadderFilter ladders[FILTERS] {};
+            for (int f = 0; f < FILTERS; ++f) {
+                svfs[f].reset();
+                svfs[f].sampleRate = SAMPLE_RATE;
+                svfs[f].updateCoefficients(500.0f * float(f + 1), Q);
+                ladders[f].reset();
+                ladders[f].sampleRate = SAMPLE_RATE;
+                ladders[f].nonlinear = type == FILTER_LADDER_DRIVE;
+                ladders[f].updateCoefficients(500.0f * float(f + 1), Q);
+            }
+            const bool ladder = type >= FILTER_LADDER;
+            auto sample = [&](int f, float x) {
+                return ladder ? ladders[f].render(x) : svfs[f].render(x, type);
+            };
+            const double render = Analysis::nanoseconds([&]() {
+                float sum = 0.0f;
+                for (int i = 0; i < SAMPLES; ++i) {
+                    for (int f = 0; f < FILTERS; ++f) {
+                        sum += sample(f, input[size_t(i)]);
+                    }
+                }
+                Analysis::keep(sum);
+            }, double(SAMPLES * FILTERS));
+            const double update = Analysis::nanoseconds([&]() {
+                float sum = 0.0f;
+                for (int i = 0; i < UPDATES; ++i) {
+                    for (int f = 0; f < FILTERS; ++f) {
+                        if (ladder) {
+                            ladders[f].updateCoefficients(cutoffs[size_t(i)] + float(f), Q);
+                        } else {
+                            svfs[f].updateCoefficients(cutoffs[size_t(i)] + float(f), Q);
+                        }
+                        sum += sample(f, input[size_t(i)]);
+                    }
+                }
+                Analysis::keep(sum);
+            }, double(UPDATES * FILTERS));
+            std::printf("  %-12s   %5.1f ns            %5.1f ns\n", names[type], render, update);
+        }
+        std::printf("\n");
+    }
+
+    // A 1 kHz sine through the voice's filter, with the cutoff swept from 2 kHz up to
+    // 15 kHz and back over two seconds, one step per chunk.  It crosses the oversampling
+    // threshold (9.6 kHz) twice
+    std::vector<float> sweep(int maxOversampling, int& switches) {
+        constexpr int SAMPLES = 2 * int(SAMPLE_RATE);
+        std::vector<float> input(SAMPLES), out(SAMPLES);
+        for (int i = 0; i < SAMPLES; ++i) {
+            input[size_t(i)] = 0.5f * std::sin(2.0f * float(M_PI) * 1000.0f * float(i) / SAMPLE_RATE);
+        }
+        VoiceRunner runner;
+        runner.prepare(SAMPLE_RATE, OSC_BLIT);
+        runner.noteOn(100.0f);
+        runner.silenceOscillators();
+        runner.getSettings().filterQ = 2.0f;
+        runner.getSettings().maxOversampling = maxOversampling;
+        switches = 0;
+        int oversampling = 1;
+        for (int offset = 0; offset < SAMPLES; offset += BLOCK_SIZE) {
+            const float t = float(offset) / float(SAMPLES);
+            const float up = t < 0.5f ? 2.0f * t : 2.0f - 2.0f * t;
+            runner.setCutoff(2000.0f * std::pow(7.5f, up));
+            runner.render(out.data() + offset, BLOCK_SIZE, input.data() + offset);
+            switches += runner.getOversampling() != oversampling ? 1 : 0;
+            oversampling = runner.getOversampling();
+        }
+        return out;
+    }
+
+    // A mid-note switch used to jump between paths with different latencies, and that's
+    // a click.  The largest step between two samples shows it against the same sweep with
+    // the oversampling off, and the difference from that run (delayed by the latency)
+    // shows the paths line up
+    void oversamplingSwitches() {
+        std::printf("Oversampling switches in the middle of a note, 1 kHz sine at 0.5,\n");
+        std::printf("cutoff swept 2 kHz - 15 kHz - 2 kHz, Q 2\n");
+        std::printf("  oversampling  switches  largest step  difference from 1x\n");
+        int switches = 0;
+        const auto reference = sweep(1, switches);
+        const size_t start = size_t(SAMPLE_RATE / 10.0f);
+        auto largestStep = [start](const std::vector<float>& x) {
+            float largest = 0.0f;
+            for (size_t i = start; i < x.size(); ++i) {
+                largest = std::max(largest, std::abs(x[i] - x[i - 1]));
+            }
+            return largest;
+        };
+        std::printf("  off           %d         %.4f        -\n", switches, largestStep(reference));
+        for (int maxOversampling : { 2, 4 }) {
+            const auto out = sweep(maxOversampling, switches);
+            const size_t latency = maxOversampling == 4 ? 29 : 19;
+            float difference = 0.0f;
+            for (size_t i = start; i < out.size(); ++i) {
+                difference = std::max(difference, std::abs(out[i] - reference[i - latency]));
+            }
+            std::printf("  %dx            %d         %.4f        %.4f\n", maxOversampling, switches, largestStep(out), difference);
+        }
+        std::printf("\n");
+    }
+}
+
+void benchFilters() {
+    std::printf("== Voice filter (Voice.h, Filter.h, FilterCoefficientTable.h, Oversampler.h)\n\n");
+    coefficientTableAccuracy();
+    coefficientUpdateCost();
+    filterModelCost();
+    oversamplingSwitches();
+}
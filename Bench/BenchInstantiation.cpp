@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    BenchInstantiation.cpp
+    Created: 20 Oct 2026 3:41:18pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "Bench.h"
+#include "Analysis.h"
+#include "../Source/Voice.h"
+#include "../Source/LFO.h"
+#include "../Source/MidiCCMap.h"
+
+// The processor, its parameters and Synth itself need JUCE, so this only builds the
+// parts of an instance that don't: Synth's voices, noise generator and LFO, and the
+// processor's CC map.  The tables prepareToPlay gets are timed in BenchSharedResources
+namespace {
+    // What the constructor builds now: the LFO points at the shared sine table and
+    // nothing is reset until prepareToPlay
+    struct Instance {
+        std::array<Voice, MAX_VOICES> voices;
+        NoiseGenerator noiseGen;
+        LFO lfo;
+        MidiCCMap ccMap;
+    };
+
+    // How it was before: every LFO filled its own sine table, and setCurrentProgram(0)
+    // reset the synth from the constructor
+    struct OldInstance : Instance {
+        float sineTable[LFO::TABLE_SIZE + 1];
+
+        OldInstance() {
+            for (int i = 0; i <= LFO::TABLE_SIZE; ++i) {
+                sineTable[i] = float(std::sin(double(TWO_PI) * double(i) / double(LFO::TABLE_SIZE)));
+            }
+            for (int v = 0; v < MAX_VOICES; v++) {
+                voices[size_t(v)].reset();
+                voices[size_t(v)].noiseGen.reset(22222u + 7919u * unsigned(v + 1));
+            }
+            noiseGen.reset();
+            lfo.reset();
+        }
+    };
+
+    // Microseconds per instance to construct `count` of them, the quickest of a few
+    // runs.  Tearing them down isn't timed
+    template<typename T>
+    double constructionTime(int count) {
+        double best = 1e300;
+        for (int run = 0; run < 5; ++run) {
+            std::vector<std::unique_ptr<T>> instances;
+            instances.reserve(size_t(count));
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < count; ++i) {
+                instances.push_back(std::make_unique<T>());
+            }
+            auto end = std::chrono::steady_clock::now();
+            Analysis::keep(float(instances.back()->voices[0].note));
+            best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+        }
+        return best / double(count);
+    }
+}
+
+void benchInstantiation() {
+    std::printf("== Instantiation (PluginProcessor.cpp, Synth.cpp, LFO.h)\n\n");
+    std::printf("Constructing the synth's voices, noise generator and LFO and the CC map,\n");
+    std::printf("%d bytes per instance.  The JUCE parts (processor, parameters, editor) aren't\n",
+                int(sizeof(Instance)));
+    std::printf("included\n");
+    std::printf("  instances   before         now            per instance\n");
+    for (int count : { 1, 10, 100 }) {
+        const double before = constructionTime<OldInstance>(count);
+        const double now = constructionTime<Instance>(count);
+        std::printf("  %3d         %8.1f us    %8.1f us    %5.2f us -> %5.2f us\n", count,
+                    before * double(count), now * double(count), before, now);
+    }
+    // The table is built the first time an LFO is, so do that before timing it
+    LFO first;
+    Analysis::keep(first.inc);
+    const double lfoBefore = Analysis::nanoseconds([]() {
+        float sineTable[LFO::TABLE_SIZE + 1];
+        for (int i = 0; i <= LFO::TABLE_SIZE; ++i) {
+            sineTable[i] = float(std::sin(double(TWO_PI) * double(i) / double(LFO::TABLE_SIZE)));
+        }
+        Analysis::keep(sineTable[LFO::TABLE_SIZE / 4]);
+    }, 1.0);
+    const double lfoNow = Analysis::nanoseconds([]() {
+        for (int i = 0; i < 1000; ++i) {
+            LFO lfo;
+            lfo.reset();
+            float value;
+            lfo.renderBlock(&value, 1);
+            Analysis::keep(value);
+        }
+    }, 1000.0);
+    std::printf("One LFO: %.0f ns building its own sine table, %.1f ns with the shared one\n\n", lfoBefore, lfoNow);
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    BenchModulation.cpp
+    Created: 20 Oct 2026 4:47:20pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "Bench.h"
+#include "Analysis.h"
+#include "VoiceRunner.h"
+#include "../Source/LFO.h"
+
+namespace {
+    constexpr float SAMPLE_RATE = 48000.0f;
+
+    // The table sine against std::sin, over every phase the LFO steps through
+    void lfoAccuracyAndCost() {
+        constexpr int VALUES = 1 << 16;
+        // Not a whole number of steps per cycle, so the phases don't repeat
+        const float inc = 1.0f / 257.3f;
+        LFO lfo;
+        lfo.reset();
+        lfo.inc = inc;
+        std::vector<float> values(VALUES);
+        lfo.renderBlock(values.data(), VALUES);
+        double largest = 0.0;
+        float phase = 0.0f;
+        for (float value : values) {
+            // The same float steps the LFO takes
+            phase += inc;
+            if (phase >= 1.0f) {
+                phase -= 1.0f;
+            }
+            largest = std::max(largest, std::abs(double(value) - std::sin(2.0 * M_PI * double(phase))));
+        }
+
+        const double table = Analysis::nanoseconds([&]() {
+            lfo.renderBlock(values.data(), VALUES);
+            Analysis::keep(values[VALUES - 1]);
+        }, double(VALUES));
+        // What the synth used to do for every value
+        const double sine = Analysis::nanoseconds([&]() {
+            float p = 0.0f;
+            for (auto& value : values) {
+                p += inc;
+                p -= float(int(p));
+                value = std::sin(TWO_PI * p);
+            }
+            Analysis::keep(values[VALUES - 1]);
+        }, double(VALUES));
+        std::printf("LFO sine: table within %.1e of std::sin, %.1f ns per value against %.1f ns\n",
+                    largest, table, sine);
+    }
+
+    // The whole voice with the modulation (glide, filter envelope and the filter
+    // coefficients) updated every sample, like before, and every LFO_MAX samples
+    void controlRateCost() {
+        constexpr int VOICES = 8;
+        constexpr int SAMPLES = 48000;
+        std::vector<float> out(SAMPLES);
+        auto cost = [&](int interval) {
+            std::vector<VoiceRunner> voices(VOICES);
+            for (int v = 0; v < VOICES; ++v) {
+                voices[size_t(v)].prepare(SAMPLE_RATE, OSC_BLIT);
+                voices[size_t(v)].noteOn(40.0f + float(v) * 13.7f);
+                voices[size_t(v)].setCutoff(2000.0f);
+                voices[size_t(v)].setUpdateInterval(interval);
+            }
+            return Analysis::nanoseconds([&]() {
+                for (auto& voice : voices) {
+                    voice.render(out.data(), SAMPLES);
+                }
+                Analysis::keep(out[0]);
+            }, double(SAMPLES * VOICES));
+        };
+        std::printf("Voice cost per sample (BLIT, SVF, exact coefficients), modulation updated\n");
+        std::printf("  every sample: %.1f ns, every %d samples: %.1f ns\n\n", cost(1), LFO_MAX, cost(LFO_MAX));
+    }
+}
+
+void benchModulation() {
+    std::printf("== Control rate modulation (LFO.h, Voice.h)\n\n");
+    lfoAccuracyAndCost();
+    controlRateCost();
+}
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    BenchNoise.cpp
+    Created: 20 Oct 2026 4:12:51pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "Bench.h"
+#include "Analysis.h"
+#include "../Source/NoiseGenerator.h"
+
+namespace {
+    constexpr double SAMPLE_RATE = 48000.0;
+    constexpr int NUM_TYPES = 4;
+    const char* const TYPE_NAMES[NUM_TYPES] = { "Original", "White", "Pink", "Brown" };
+
+    // A chunk at a time, like Synth::render.  Type 0 is the white noise from before
+    // SOUND_VERSION_NOISE, the others are NOISE_WHITE, NOISE_PINK and NOISE_BROWN
+    void fill(NoiseGenerator& generator, int type, std::vector<float>& out) {
+        const int count = int(out.size());
+        for (int offset = 0; offset < count; offset += BLOCK_SIZE) {
+            const int chunk = std::min(BLOCK_SIZE, count - offset);
+            generator.fillBlock(out.data() + offset, chunk, std::max(type - 1, 0), type == 0);
+        }
+    }
+
+    std::vector<float> noise(int type, int count, unsigned int seed = 22222) {
+        NoiseGenerator generator;
+        generator.reset(seed);
+        std::vector<float> out(size_t(count), 0.0f);
+        fill(generator, type, out);
+        return out;
+    }
+
+    // Average power per bin between two frequencies
+    double bandDensity(const std::vector<double>& power, double low, double high) {
+        const double binWidth = SAMPLE_RATE / double(2 * power.size());
+        double sum = 0.0;
+        int bins = 0;
+        for (size_t k = size_t(low / binWidth); k < size_t(high / binWidth); ++k) {
+            sum += power[k];
+            ++bins;
+        }
+        return sum / double(bins);
+    }
+
+    double correlation(const std::vector<float>& a, const std::vector<float>& b) {
+        double ab = 0.0, aa = 0.0, bb = 0.0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            ab += double(a[i]) * double(b[i]);
+            aa += double(a[i]) * double(a[i]);
+            bb += double(b[i]) * double(b[i]);
+        }
+        return ab / std::sqrt(aa * bb);
+    }
+}
+
+void benchNoise() {
+    std::printf("== Noise (NoiseGenerator.h)\n\n");
+
+    // The slope is measured between 500 Hz - 1 kHz and 4 kHz - 8 kHz, three octaves
+    // apart.  Pink should be -3 dB per octave and brown -6
+    std::printf("Noise, filled a chunk at a time at 48 kHz\n");
+    std::printf("  type       per sample  RMS     slope\n");
+    for (int type = 0; type < NUM_TYPES; ++type) {
+        constexpr int SAMPLES = 1 << 18;
+        NoiseGenerator generator;
+        generator.reset();
+        // Small enough to stay in the cache, like the synth's chunk buffers
+        std::vector<float> buffer(1024);
+        const double cost = Analysis::nanoseconds([&]() {
+            for (int i = 0; i < SAMPLES; i += int(buffer.size())) {
+                fill(generator, type, buffer);
+                Analysis::keep(buffer[0]);
+            }
+        }, double(SAMPLES));
+        // Averaged over 16 spectra so the bands are smooth
+        std::vector<double> power(1 << 11, 0.0);
+        const auto x = noise(type, SAMPLES);
+        for (size_t start = 0; start + (1 << 12) <= x.size(); start += 1 << 14) {
+            const auto part = Analysis::powerSpectrum(std::vector<float>(x.begin() + long(start), x.begin() + long(start) + (1 << 12)));
+            for (size_t k = 0; k < power.size(); ++k) {
+                power[k] += part[k];
+            }
+        }
+        const double slope = 10.0 * std::log10(bandDensity(power, 4000.0, 8000.0) / bandDensity(power, 500.0, 1000.0)) / 3.0;
+        std::printf("  %-9s  %4.2f ns     %.3f   %5.1f dB/octave\n", TYPE_NAMES[type], cost, Analysis::rms(x), slope);
+    }
+
+    // Per Voice noise seeds each voice like Synth::reset does
+    const auto voice1 = noise(1, 1 << 18, 22222u + 7919u);
+    const auto voice2 = noise(1, 1 << 18, 22222u + 7919u * 2u);
+    std::printf("Correlation between two voices' white noise: %.4f\n\n", correlation(voice1, voice2));
+}
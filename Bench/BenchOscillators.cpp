@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    BenchOscillators.cpp
+    Created: 20 Oct 2026 10:02:17am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+#include "Bench.h"
+#include "Analysis.h"
+#include "VoiceRunner.h"
+
+namespace {
+    constexpr double SAMPLE_RATE = 48000.0;
+    constexpr int ENGINES = 4;
+    const char* const ENGINE_NAMES[ENGINES] = { "BLIT", "PolyBLEP", "Wavetable", "BLIT Table" };
+
+    WavetableBank bank;
+
+    // The impulse engines go through the leaky integrator like in Voice::render, the
+    // others output the saw directly
+    template<typename Osc>
+    std::vector<float> saw(Osc& osc, bool integrate, double f0, int count) {
+        osc.reset();
+        osc.amplitude = 0.3f;
+        osc.period = float(SAMPLE_RATE / f0);
+        float integrator = 0.0f;
+        auto next = [&]() {
+            integrator = integrate ? integrator * 0.997f + osc.nextSample() : osc.nextSample();
+            return integrator;
+        };
+        // Let the integrator settle first
+        for (int i = 0; i < int(SAMPLE_RATE / 10.0); ++i) {
+            next();
+        }
+        std::vector<float> out(size_t(count), 0.0f);
+        for (auto& sample : out) {
+            sample = next();
+        }
+        return out;
+    }
+
+    std::vector<float> engineSaw(int engine, double f0) {
+        constexpr int N = 1 << 16;
+        if (engine == OSC_POLYBLEP) {
+            PolyBLEPOscillator osc {};
+            return saw(osc, false, f0, N);
+        } else if (engine == OSC_WAVETABLE) {
+            WavetableOscillator osc {};
+            osc.bank = &bank;
+            return saw(osc, false, f0, N);
+        } else if (engine == OSC_BLIT_TABLE) {
+            BlitTableOscillator osc {};
+            return saw(osc, true, f0, N);
+        }
+        Oscillator osc {};
+        return saw(osc, true, f0, N);
+    }
+
+    // 8 oscillators at different pitches, nanoseconds per oscillator per sample
+    template<typename Osc>
+    double oscillatorCost() {
+        constexpr int OSCILLATORS = 8;
+        constexpr int SAMPLES = 96000;
+        Osc oscs[OSCILLATORS] {};
+        for (int i = 0; i < OSCILLATORS; ++i) {
+            oscs[i].reset();
+            oscs[i].period = 40.0f + float(i) * 13.7f;
+            if constexpr (std::is_same_v<Osc, WavetableOscillator>) {
+                oscs[i].bank = &bank;
+            }
+        }
+        return Analysis::nanoseconds([&]() {
+            float sum = 0.0f;
+            for (int n = 0; n < SAMPLES; ++n) {
+                for (auto& osc : oscs) {
+                    sum += osc.nextSample();
+                }
+            }
+            Analysis::keep(sum);
+        }, double(SAMPLES * OSCILLATORS));
+    }
+
+    // The whole voice (two oscillators, SVF, envelope), nanoseconds per voice per sample
+    double voiceCost(int engine) {
+        constexpr int VOICES = 8;
+        constexpr int SAMPLES = 48000;
+        std::vector<VoiceRunner> voices(VOICES);
+        std::vector<float> out(SAMPLES);
+        for (int v = 0; v < VOICES; ++v) {
+            voices[size_t(v)].prepare(float(SAMPLE_RATE), engine, &bank);
+            voices[size_t(v)].noteOn(40.0f + float(v) * 13.7f);
+        }
+        return Analysis::nanoseconds([&]() {
+            for (auto& voice : voices) {
+                voice.render(out.data(), SAMPLES);
+            }
+            Analysis::keep(out[0]);
+        }, double(SAMPLES * VOICES));
+    }
+
+    // The table version against the recursion it replaces, on the same notes
+    void blitTableAgainstRecursion() {
+        std::printf("BLIT table against the recursion, after the leaky integrator\n");
+        std::printf("                alias                 table / recursion\n");
+        std::printf("  note       recursion   table      fundamental  RMS\n");
+        for (double f0 : { 220.0, 1046.5, 2637.0, 5274.0, 8372.0 }) {
+            const auto recursion = engineSaw(OSC_BLIT, f0);
+            const auto table = engineSaw(OSC_BLIT_TABLE, f0);
+            std::printf("  %6.0f Hz  %6.1f dB  %6.1f dB  %.3f        %.3f\n", f0,
+                        Analysis::aliasDb(recursion, f0, SAMPLE_RATE, 20000.0),
+                        Analysis::aliasDb(table, f0, SAMPLE_RATE, 20000.0),
+                        Analysis::toneLevel(table, f0, SAMPLE_RATE) / Analysis::toneLevel(recursion, f0, SAMPLE_RATE),
+                        Analysis::rms(table) / Analysis::rms(recursion));
+        }
+        std::printf("\n");
+
+        // The sinc's cutoff is below Nyquist, so the top harmonics come out quieter
+        const double f0 = 220.0;
+        const auto recursion = engineSaw(OSC_BLIT, f0);
+        const auto table = engineSaw(OSC_BLIT_TABLE, f0);
+        std::printf("Top harmonics of a 220 Hz saw, table relative to the recursion\n");
+        for (double f : { 10000.0, 15000.0, 18000.0, 20000.0, 22000.0 }) {
+            const double harmonic = std::round(f / f0) * f0;
+            std::printf("  %5.0f Hz  %6.2f dB\n", harmonic,
+                        Analysis::toDb(Analysis::toneLevel(table, harmonic, SAMPLE_RATE) /
+                                       Analysis::toneLevel(recursion, harmonic, SAMPLE_RATE)));
+        }
+
+        // How far behind the table runs: the lag that lines the two saws up best
+        int bestLag = 0;
+        double bestCorrelation = -1e300;
+        for (int lag = 0; lag < SincTable::KERNEL_LENGTH; ++lag) {
+            double correlation = 0.0;
+            for (size_t i = 0; i + size_t(lag) < table.size(); ++i) {
+                correlation += double(recursion[i]) * double(table[i + size_t(lag)]);
+            }
+            if (correlation > bestCorrelation) {
+                bestCorrelation = correlation;
+                bestLag = lag;
+            }
+        }
+        std::printf("Delay behind the recursion: %d samples\n", bestLag);
+        std::printf("Sinc table: %d x %d taps, %d bytes, one per process\n\n",
+                    SincTable::OVERSAMPLE + 1, SincTable::KERNEL_LENGTH, int(sizeof(SincTable)));
+    }
+}
+
+void benchOscillators() {
+    std::printf("== Oscillator engines (Oscillator.h, PolyBLEPOscillator.h, WavetableOscillator.h,\n");
+    std::printf("   BlitTableOscillator.h)\n\n");
+
+    // A fresh bank every time, build() does nothing once the tables are there
+    const double build = Analysis::nanoseconds([]() {
+        WavetableBank fresh;
+        fresh.build();
+        Analysis::keep(fresh.tableForPeriod(100.0f)[1]);
+    }, 1e6, 3);
+    bank.build();
+    std::printf("Wavetable bank build: %.1f ms\n\n", build);
+
+    std::printf("Alias energy below 20 kHz at 48 kHz, relative to the harmonics, and RMS level\n");
+    std::printf("  engine         220 Hz    1046 Hz    2637 Hz    5274 Hz    RMS at 220 Hz\n");
+    for (int engine = 0; engine < ENGINES; ++engine) {
+        std::printf("  %-10s", ENGINE_NAMES[engine]);
+        for (double f0 : { 220.0, 1046.5, 2637.0, 5274.0 }) {
+            std::printf("  %6.1f dB", Analysis::aliasDb(engineSaw(engine, f0), f0, SAMPLE_RATE, 20000.0));
+        }
+        std::printf("  %.3f\n", Analysis::rms(engineSaw(engine, 220.0)));
+    }
+    std::printf("\n");
+
+    std::printf("Cost per sample\n");
+    std::printf("  engine      oscillator   full voice\n");
+    const double oscillator[ENGINES] = {
+        oscillatorCost<Oscillator>(),
+        oscillatorCost<PolyBLEPOscillator>(),
+        oscillatorCost<WavetableOscillator>(),
+        oscillatorCost<BlitTableOscillator>()
+    };
+    for (int engine = 0; engine < ENGINES; ++engine) {
+        std::printf("  %-10s  %5.1f ns     %5.1f ns\n", ENGINE_NAMES[engine], oscillator[engine], voiceCost(engine));
+    }
+    std::printf("\n");
+
+    blitTableAgainstRecursion();
+}
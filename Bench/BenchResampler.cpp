@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    BenchResampler.cpp
+    Created: 20 Oct 2026 9:20:51am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include <cstdio>
+#include <vector>
+#include "Bench.h"
+#include "Analysis.h"
+#include "VoiceRunner.h"
+#include "../Source/Resampler.h"
+
+namespace {
+    constexpr double INTERNAL_RATE = 48000.0;
+
+    // The default engine going through the leaky integrator, like Voice::render
+    std::vector<float> blitSaw(double sampleRate, double frequency, int count) {
+        Oscillator osc {};
+        osc.reset();
+        osc.amplitude = 0.3f;
+        osc.period = float(sampleRate / frequency);
+        float saw = 0.0f;
+        // Let the integrator settle first
+        for (int i = 0; i < int(sampleRate / 10.0); ++i) {
+            saw = saw * 0.997f + osc.nextSample();
+        }
+        std::vector<float> out(size_t(count), 0.0f);
+        for (auto& sample : out) {
+            saw = saw * 0.997f + osc.nextSample();
+            sample = saw;
+        }
+        return out;
+    }
+
+    std::vector<float> upsample(const std::vector<float>& input, int factor) {
+        Upsampler upsampler;
+        upsampler.prepare(factor);
+        std::vector<float> out(input.size() * size_t(factor));
+        upsampler.process(input.data(), out.data(), int(input.size()));
+        // Skip the filter's start up
+        out.erase(out.begin(), out.begin() + 2 * upsampler.getLatency());
+        return out;
+    }
+
+    void frequencyResponse() {
+        std::printf("Upsampler response (input at 48 kHz)\n");
+        std::printf("  factor  tone       gain      image\n");
+        for (int factor : { 2, 4 }) {
+            for (double f : { 1000.0, 10000.0, 18000.0, 20000.0, 21000.0 }) {
+                std::vector<float> in(8192);
+                for (size_t i = 0; i < in.size(); ++i) {
+                    in[i] = 0.5f * float(std::sin(2.0 * M_PI * f * double(i) / INTERNAL_RATE));
+                }
+                const auto out = upsample(in, factor);
+                const double outputRate = INTERNAL_RATE * factor;
+                const double level = Analysis::toneLevel(out, f, outputRate);
+                // The first image is mirrored around the internal rate's Nyquist
+                const double image = Analysis::toneLevel(out, INTERNAL_RATE - f, outputRate);
+                std::printf("  %dx      %5.0f Hz  %6.2f dB  %7.1f dB\n", factor, f,
+                            Analysis::toDb(level / 0.5), Analysis::toDb(image / level));
+            }
+        }
+        std::printf("\n");
+    }
+
+    // The reported latency should be where an impulse comes out, to the sample
+    void latency() {
+        std::printf("Upsampler latency (host samples)\n");
+        std::printf("  factor  getLatency()  impulse peak\n");
+        for (int factor : { 2, 4 }) {
+            Upsampler upsampler;
+            upsampler.prepare(factor);
+            std::vector<float> in(64, 0.0f);
+            in[0] = 1.0f;
+            std::vector<float> out(in.size() * size_t(factor));
+            upsampler.process(in.data(), out.data(), int(in.size()));
+            const auto peak = std::max_element(out.begin(), out.end()) - out.begin();
+            std::printf("  %dx      %3d           %3d\n", factor, upsampler.getLatency(), int(peak));
+        }
+        std::printf("\n");
+    }
+
+    // Rendering at the host rate aliases less than rendering at 48 kHz, so this shows
+    // what the fixed rate gives up in the audible band.  The FFTs cover the same
+    // length of time, so the bins are the same width
+    void aliasing() {
+        std::printf("Alias energy below 20 kHz, BLIT saw, relative to the harmonics\n");
+        std::printf("  note       native 192k   48k + 4x upsampler\n");
+        for (double f0 : { 220.0, 1046.5, 2637.0, 5274.0 }) {
+            const auto native = blitSaw(4.0 * INTERNAL_RATE, f0, 1 << 18);
+            auto fixed = upsample(blitSaw(INTERNAL_RATE, f0, (1 << 16) + 64), 4);
+            fixed.resize(1 << 18);
+            std::printf("  %6.0f Hz  %8.1f dB   %8.1f dB\n", f0,
+                        Analysis::aliasDb(native, f0, 4.0 * INTERNAL_RATE, 20000.0),
+                        Analysis::aliasDb(fixed, f0, 4.0 * INTERNAL_RATE, 20000.0));
+        }
+        std::printf("\n");
+    }
+
+    // 8 voices playing, stereo output.  The native numbers are for the whole synth
+    // running at the host rate, the fixed ones render a quarter (or half) as many
+    // samples and then upsample both channels
+    void cost() {
+        constexpr int VOICES = 8;
+        constexpr int HOST_SAMPLES = 192000;
+        std::printf("Cost per host sample, %d voices (BLIT, SVF), stereo\n", VOICES);
+        std::printf("  host rate  native     fixed 48k   upsampler only\n");
+        for (int factor : { 2, 4 }) {
+            const double hostRate = INTERNAL_RATE * factor;
+            std::vector<float> voiceOut(HOST_SAMPLES), mix(HOST_SAMPLES), left(HOST_SAMPLES), right(HOST_SAMPLES);
+
+            auto renderVoices = [&](float sampleRate, int count) {
+                std::vector<VoiceRunner> voices(VOICES);
+                for (int v = 0; v < VOICES; ++v) {
+                    voices[size_t(v)].prepare(sampleRate, OSC_BLIT);
+                    voices[size_t(v)].noteOn(sampleRate / (110.0f * float(v + 1)));
+                }
+                std::fill(mix.begin(), mix.begin() + count, 0.0f);
+                for (auto& voice : voices) {
+                    voice.render(voiceOut.data(), count);
+                    for (int i = 0; i < count; ++i) {
+                        mix[size_t(i)] += voiceOut[size_t(i)];
+                    }
+                }
+                Analysis::keep(mix[size_t(count - 1)]);
+            };
+
+            const int internalSamples = HOST_SAMPLES / factor;
+            Upsampler upLeft, upRight;
+            upLeft.prepare(factor);
+            upRight.prepare(factor);
+            auto upsampleBoth = [&]() {
+                upLeft.process(mix.data(), left.data(), internalSamples);
+                upRight.process(mix.data(), right.data(), internalSamples);
+                Analysis::keep(left[0] + right[0]);
+            };
+
+            const double native = Analysis::nanoseconds([&]() { renderVoices(float(hostRate), HOST_SAMPLES); }, HOST_SAMPLES);
+            const double upsampler = Analysis::nanoseconds(upsampleBoth, HOST_SAMPLES);
+            const double fixed = Analysis::nanoseconds([&]() {
+                renderVoices(float(INTERNAL_RATE), internalSamples);
+                upsampleBoth();
+            }, HOST_SAMPLES);
+            std::printf("  %3.0f kHz    %5.1f ns   %5.1f ns    %5.1f ns\n", hostRate / 1000.0, native, fixed, upsampler);
+        }
+        std::printf("\n");
+    }
+}
+
+void benchResampler() {
+    std::printf("== Fixed internal rate (Resampler.h)\n\n");
+    frequencyResponse();
+    latency();
+    aliasing();
+    cost();
+}
@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    BenchSharedResources.cpp
+    Created: 20 Oct 2026 11:06:33am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+#include "Bench.h"
+#include "Analysis.h"
+#include "../Source/SharedResources.h"
+#include "../Source/WavetableOscillator.h"
+#include "../Source/FilterCoefficientTable.h"
+#include "../Source/BlitTableOscillator.h"
+#include "../Source/FactoryPresets.h"
+
+// Counts the heap in use, so the tables can be measured the same way on every
+// platform.  Each block carries its size in front of it.  This replaces the global
+// operator new for the whole bench, which only costs a few nanoseconds per
+// allocation and nothing the other benchmarks time allocates.
+namespace {
+    std::atomic<size_t> heapInUse { 0 };
+    constexpr size_t HEADER = alignof(std::max_align_t);
+}
+
+void* operator new(size_t size) {
+    auto* block = static_cast<char*>(std::malloc(size + HEADER));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    heapInUse += size;
+    return block + HEADER;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer != nullptr) {
+        char* block = static_cast<char*>(pointer) - HEADER;
+        heapInUse -= *reinterpret_cast<size_t*>(block);
+        std::free(block);
+    }
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+namespace {
+    constexpr float SAMPLE_RATE = 48000.0f;
+    using PresetSnapshots = std::array<RenderParams, NUM_FACTORY_PRESETS>;
+
+    void buildSnapshots(PresetSnapshots& snapshots, float sampleRate) {
+        snapshots = FACTORY_SNAPSHOTS;
+        for (int i = 0; i < NUM_FACTORY_PRESETS; ++i) {
+            RenderParams::deriveRateDependent(snapshots[size_t(i)], FACTORY_PRESETS[i].param, sampleRate);
+        }
+    }
+
+    // The tables one plugin instance needs, each instance building its own copy (how it
+    // was before the registry)
+    struct OwnedTables {
+        WavetableBank wavetables;
+        FilterCoefficientTable filterTable;
+        std::unique_ptr<PresetSnapshots> presetSnapshots;
+
+        void allocate(float sampleRate) {
+            wavetables.build();
+            filterTable.build(sampleRate);
+            presetSnapshots = std::make_unique<PresetSnapshots>();
+            buildSnapshots(*presetSnapshots, sampleRate);
+        }
+    };
+
+    // The same tables from the registry, like Synth::allocateResources and
+    // Parameters::buildPresetSnapshots get them
+    struct SharedTables {
+        std::shared_ptr<const WavetableBank> wavetables;
+        std::shared_ptr<const FilterCoefficientTable> filterTable;
+        std::shared_ptr<const PresetSnapshots> presetSnapshots;
+
+        void allocate(float sampleRate) {
+            wavetables = SharedResources<WavetableBank>::get(0.0, [](WavetableBank& bank) { bank.build(); });
+            filterTable = SharedResources<FilterCoefficientTable>::get(sampleRate, [sampleRate](FilterCoefficientTable& table) {
+                table.build(sampleRate);
+            });
+            presetSnapshots = SharedResources<PresetSnapshots>::get(sampleRate, [sampleRate](PresetSnapshots& snapshots) {
+                buildSnapshots(snapshots, sampleRate);
+            });
+        }
+    };
+
+    // Heap used by `instances` instances' tables, and how long it took to set them all up
+    template<typename Tables>
+    void measure(int instances, size_t& bytes, double& milliseconds) {
+        const size_t before = heapInUse;
+        // Not with Analysis::nanoseconds: the shared tables are only built by the first run
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Tables> tables(static_cast<size_t>(instances));
+        for (auto& instance : tables) {
+            instance.allocate(SAMPLE_RATE);
+        }
+        auto end = std::chrono::steady_clock::now();
+        bytes = heapInUse - before;
+        milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    }
+}
+
+void benchSharedResources() {
+    std::printf("== Shared read-only tables (SharedResources.h)\n\n");
+    std::printf("Heap used by the wavetable bank, the filter coefficient table and the preset\n");
+    std::printf("snapshots at 48 kHz, and the time to set up every instance's tables\n");
+    std::printf("  instances   owned                  shared\n");
+    for (int instances : { 1, 10, 100 }) {
+        size_t owned, shared;
+        double ownedTime, sharedTime;
+        measure<OwnedTables>(instances, owned, ownedTime);
+        measure<SharedTables>(instances, shared, sharedTime);
+        std::printf("  %3d         %8.1f KB %7.1f ms  %8.1f KB %7.1f ms\n", instances,
+                    double(owned) / 1024.0, ownedTime, double(shared) / 1024.0, sharedTime);
+    }
+    // Every instance above has gone, so the registry should have let go of the tables
+    std::printf("Tables still alive afterwards: %d\n",
+                SharedResources<WavetableBank>::liveCount() + SharedResources<FilterCoefficientTable>::liveCount() +
+                SharedResources<PresetSnapshots>::liveCount());
+    std::printf("The sinc table (%d bytes) is a static, so there's one per process either way\n\n",
+                int(sizeof(SincTable)));
+}
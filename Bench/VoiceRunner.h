@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    VoiceRunner.h
+    Created: 20 Oct 2026 9:14:02am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../Source/Voice.h"
+
+// Plays one held note on a Voice the way Synth::render does: the envelope and the
+// filter are updated once per BLOCK_SIZE chunk, and the oscillators and the filter
+// run on every sample.  The filter is wide open so it doesn't hide the oscillator.
+class VoiceRunner {
+    public:
+        void prepare(float sampleRate, int oscEngine, const WavetableBank* bank = nullptr) {
+            voice.reset();
+            voice.filter.sampleRate = sampleRate;
+            voice.ladder.sampleRate = sampleRate;
+            voice.setWavetables(bank);
+            settings.oscEngine = oscEngine;
+            settings.filterQ = 0.707f;
+        }
+
+        void noteOn(float period) {
+            voice.note = 60;
+            voice.setPeriods(period, period * 1.003f);
+            voice.setAmplitudes(0.3f, 0.2f);
+            voice.setPitchModulation(1.0f, 1.0f);
+            voice.period = period;
+            voice.targetPeriod = period;
+            voice.setCutoff(20000.0f);
+            voice.env.attackMultiplier = 0.0f;
+            voice.env.decayMultiplier = 1.0f;
+            voice.env.sustainLevel = 1.0f;
+            voice.env.releaseMultiplier = 0.999f;
+            voice.env.attack();
+            voice.updatePanning();
+            std::fill(voice.filterEnvBlock, voice.filterEnvBlock + MAX_UPDATES, 0.0f);
+            voice.active = true;
+        }
+
+        // Mono output, count samples.  input is added to the oscillators (like the noise)
+        void render(float* out, int count, const float* input = nullptr) {
+            for (int offset = 0; offset < count; offset += updateInterval) {
+                const int chunk = std::min(updateInterval, count - offset);
+                voice.updateLFO(settings, 0);
+                voice.renderEnvelope(chunk);
+                for (int i = 0; i < chunk; ++i) {
+                    out[offset + i] = voice.render(settings, input != nullptr ? input[offset + i] : 0.0f, i);
+                }
+            }
+        }
+
+        // Takes effect at the start of the next chunk, like a modulation update
+        void setCutoff(float cutoff) {
+            voice.setCutoff(cutoff);
+        }
+
+        // How many samples between modulation updates, BLOCK_SIZE like the synth or less
+        void setUpdateInterval(int samples) {
+            updateInterval = std::clamp(samples, 1, BLOCK_SIZE);
+        }
+
+        // So only the input is heard
+        void silenceOscillators() {
+            voice.setAmplitudes(0.0f, 0.0f);
+        }
+
+        VoiceSettings& getSettings() noexcept {
+            return settings;
+        }
+
+        int getOversampling() const noexcept {
+            return voice.oversampling;
+        }
+
+    private:
+        Voice voice;
+        VoiceSettings settings;
+        int updateInterval = BLOCK_SIZE;
+};
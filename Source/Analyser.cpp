@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    Analyser.cpp
+    Created: 20 Oct 2026 2:08:45am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include "Analyser.h"
+
+Analyser::Analyser(JX11AudioProcessor& processor) : audioProcessor(processor) {
+    spectrum.fill(MIN_DB);
+    setOpaque(true);
+    audioProcessor.getAnalyserFifo().setActive(true);
+    startTimerHz(MAX_FRAME_RATE);
+}
+
+Analyser::~Analyser() {
+    // The audio thread stops pushing samples as soon as this is seen
+    audioProcessor.getAnalyserFifo().setActive(false);
+}
+
+void Analyser::timerCallback() {
+    int count = audioProcessor.getAnalyserFifo().pull(incoming.data(), int(incoming.size()));
+    if (count == 0) {
+        // Nothing playing (or no audio at all), leave the picture as it is
+        return;
+    }
+    // Slide the history along and add the new samples at the end
+    if (count >= HISTORY_SIZE) {
+        std::copy(incoming.begin() + (count - HISTORY_SIZE), incoming.begin() + count, history.begin());
+    } else {
+        std::copy(history.begin() + count, history.end(), history.begin());
+        std::copy(incoming.begin(), incoming.begin() + count, history.end() - count);
+    }
+    updateSpectrum();
+    repaint();
+}
+
+void Analyser::updateSpectrum() {
+    std::copy(history.begin(), history.end(), fftData.begin());
+    std::fill(fftData.begin() + FFT_SIZE, fftData.end(), 0.0f);
+    window.multiplyWithWindowingTable(fftData.data(), size_t(FFT_SIZE));
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+    // A full scale sine through the Hann window peaks at FFT_SIZE / 4
+    const float scale = 4.0f / float(FFT_SIZE);
+    for (int i = 0; i < NUM_BINS; ++i) {
+        float level = juce::Decibels::gainToDecibels(fftData[size_t(i)] * scale, MIN_DB);
+        spectrum[size_t(i)] = std::max(level, spectrum[size_t(i)] - FALL_DB);
+    }
+}
+
+void Analyser::paint(juce::Graphics& g) {
+    g.fillAll(juce::Colour(20, 20, 24));
+    auto r = getLocalBounds().toFloat().reduced(4.0f);
+    auto scopeArea = r.removeFromLeft(r.getWidth() * 0.4f);
+    r.removeFromLeft(8.0f);
+    paintScope(g, scopeArea);
+    paintSpectrum(g, r);
+}
+
+void Analyser::paintScope(juce::Graphics& g, juce::Rectangle<float> area) const {
+    g.setColour(juce::Colour(60, 60, 66));
+    g.drawHorizontalLine(juce::roundToInt(area.getCentreY()), area.getX(), area.getRight());
+
+    // Start at a rising zero crossing, so a steady note stands still
+    int start = HISTORY_SIZE - SCOPE_SIZE;
+    for (int i = start; i > 0; --i) {
+        if (history[size_t(i - 1)] < 0.0f && history[size_t(i)] >= 0.0f) {
+            start = i;
+            break;
+        }
+    }
+    juce::Path path;
+    const float xScale = area.getWidth() / float(SCOPE_SIZE - 1);
+    const float yScale = area.getHeight() * 0.5f;
+    for (int i = 0; i < SCOPE_SIZE; ++i) {
+        float sample = juce::jlimit(-1.0f, 1.0f, history[size_t(start + i)]);
+        float x = area.getX() + float(i) * xScale;
+        float y = area.getCentreY() - sample * yScale;
+        if (i == 0) {
+            path.startNewSubPath(x, y);
+        } else {
+            path.lineTo(x, y);
+        }
+    }
+    g.setColour(findColour(juce::Slider::rotarySliderFillColourId));
+    g.strokePath(path, juce::PathStrokeType(1.5f));
+}
+
+void Analyser::paintSpectrum(juce::Graphics& g, juce::Rectangle<float> area) const {
+    const float nyquist = float(audioProcessor.getSampleRate()) * 0.5f;
+    if (nyquist <= 20.0f) {
+        return;
+    }
+    // Log frequency from 20 Hz, so the harmonics and any aliasing under them spread out
+    const float logRange = std::log(nyquist / 20.0f);
+    auto xForFrequency = [&](float frequency) {
+        return area.getX() + area.getWidth() * std::log(frequency / 20.0f) / logRange;
+    };
+    auto yForLevel = [&](float level) {
+        return area.getY() + area.getHeight() * (level / MIN_DB);
+    };
+
+    g.setColour(juce::Colour(60, 60, 66));
+    for (float frequency : { 100.0f, 1000.0f, 10000.0f }) {
+        if (frequency < nyquist) {
+            g.drawVerticalLine(juce::roundToInt(xForFrequency(frequency)), area.getY(), area.getBottom());
+        }
+    }
+    for (float level = -20.0f; level > MIN_DB; level -= 20.0f) {
+        g.drawHorizontalLine(juce::roundToInt(yForLevel(level)), area.getX(), area.getRight());
+    }
+
+    juce::Path path;
+    const float binWidth = nyquist / float(NUM_BINS);
+    bool started = false;
+    for (int i = 1; i < NUM_BINS; ++i) {
+        float frequency = float(i) * binWidth;
+        if (frequency < 20.0f) {
+            continue;
+        }
+        float x = xForFrequency(frequency);
+        float y = yForLevel(juce::jlimit(MIN_DB, 0.0f, spectrum[size_t(i)]));
+        if (!started) {
+            path.startNewSubPath(x, y);
+            started = true;
+        } else {
+            path.lineTo(x, y);
+        }
+    }
+    g.setColour(juce::Colours::white.withAlpha(0.8f));
+    g.strokePath(path, juce::PathStrokeType(1.0f));
+}
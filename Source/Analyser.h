@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    Analyser.h
+    Created: 20 Oct 2026 2:08:45am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// An oscilloscope on the left and a spectrum on the right, of the synth's output
+// (before the preset previews are mixed in).  Handy for checking the BLIT oscillator
+// for aliasing and the filter for self-oscillation.  The samples come through the
+// processor's AnalyserFifo, and the FFT runs here on the message thread, at most
+// MAX_FRAME_RATE times a second and only when new samples have come in.
+class Analyser : public juce::Component, private juce::Timer {
+    public:
+        explicit Analyser(JX11AudioProcessor& processor);
+        ~Analyser() override;
+        void paint(juce::Graphics& g) override;
+    private:
+        static constexpr int FFT_ORDER = 11;
+        static constexpr int FFT_SIZE = 1 << FFT_ORDER;
+        static constexpr int NUM_BINS = FFT_SIZE / 2;
+        // What the scope shows.  The rest of the history is room to look back for a trigger point
+        static constexpr int SCOPE_SIZE = 512;
+        static constexpr int HISTORY_SIZE = FFT_SIZE;
+        static constexpr int MAX_FRAME_RATE = 30;
+        static constexpr float MIN_DB = -100.0f;
+        // How fast the spectrum falls back, in dB per frame
+        static constexpr float FALL_DB = 3.0f;
+
+        JX11AudioProcessor& audioProcessor;
+        juce::dsp::FFT fft { FFT_ORDER };
+        juce::dsp::WindowingFunction<float> window { size_t(FFT_SIZE), juce::dsp::WindowingFunction<float>::hann };
+        // The latest samples, oldest first
+        std::array<float, HISTORY_SIZE> history {};
+        std::array<float, AnalyserFifo::CAPACITY> incoming;
+        // The FFT works in place and needs twice the size
+        std::array<float, FFT_SIZE * 2> fftData;
+        std::array<float, NUM_BINS> spectrum;
+
+        void timerCallback() override;
+        void updateSpectrum();
+        void paintScope(juce::Graphics& g, juce::Rectangle<float> area) const;
+        void paintSpectrum(juce::Graphics& g, juce::Rectangle<float> area) const;
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Analyser)
+};
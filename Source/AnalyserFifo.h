@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    AnalyserFifo.h
+    Created: 20 Oct 2026 2:08:45am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+// Carries the synth's output from the audio thread to the analyser in the editor.
+// Single producer, single consumer, a fixed array and no locks.  While nobody is
+// looking (the editor is closed) push returns straight away, so it costs one atomic
+// load per block.
+class AnalyserFifo {
+    public:
+        // About a third of a second at 48 kHz, plenty for a 30 Hz reader
+        static constexpr int CAPACITY = 16384;
+
+        // Audio thread.  Mono, the average of the first two channels.  What doesn't fit
+        // is dropped, the analyser only needs the latest samples anyway
+        void push(const juce::AudioBuffer<float>& buffer) {
+            if (!active.load()) {
+                return;
+            }
+            const float* left = buffer.getReadPointer(0);
+            const float* right = buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : left;
+            const auto scope = fifo.write(buffer.getNumSamples());
+            copyMono(left, right, scope.startIndex1, scope.blockSize1);
+            copyMono(left + scope.blockSize1, right + scope.blockSize1, scope.startIndex2, scope.blockSize2);
+        }
+
+        // Message thread.  Returns how many samples it copied into destination
+        int pull(float* destination, int maxSamples) {
+            const auto scope = fifo.read(std::min(maxSamples, fifo.getNumReady()));
+            std::copy(samples.begin() + scope.startIndex1, samples.begin() + scope.startIndex1 + scope.blockSize1, destination);
+            std::copy(samples.begin() + scope.startIndex2, samples.begin() + scope.startIndex2 + scope.blockSize2,
+                      destination + scope.blockSize1);
+            return scope.blockSize1 + scope.blockSize2;
+        }
+
+        // The analyser switches it on while it's showing
+        void setActive(bool shouldBeActive) { active.store(shouldBeActive); }
+
+    private:
+        juce::AbstractFifo fifo { CAPACITY };
+        std::array<float, CAPACITY> samples;
+        std::atomic<bool> active { false };
+
+        void copyMono(const float* left, const float* right, int start, int count) {
+            for (int i = 0; i < count; ++i) {
+                samples[size_t(start + i)] = 0.5f * (left[i] + right[i]);
+            }
+        }
+};
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    BlitTableOscillator.h
+    Created: 19 Oct 2026 4:22:09pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstring>
+#include "Constants.h"
+
+// Windowed sinc impulses, tabulated at OVERSAMPLE fractional positions.  Row r holds the
+// KERNEL_LENGTH taps of an impulse that happened r / OVERSAMPLE of a sample ago.  The kernel
+// is measured in samples, so one table works at every sample rate.  It is built the first
+// time get() is called and then shared (read only) by every voice of every plugin instance.
+class SincTable {
+    public:
+        static constexpr int ZERO_CROSSINGS = 16;
+        static constexpr int KERNEL_LENGTH = 2 * ZERO_CROSSINGS;
+        static constexpr int OVERSAMPLE = 64;
+    
+        // Not real-time safe the first time it's called, so call it from allocateResources
+        static const SincTable& get() {
+            static const SincTable table;
+            return table;
+        }
+    
+        const float* row(int r) const noexcept {
+            return taps[r];
+        }
+    
+    private:
+        SincTable() {
+            const double cutoff = 0.42;   // cycles per sample, a little under Nyquist so the Blackman transition fits
+            for (int r = 0; r <= OVERSAMPLE; ++r) {
+                double frac = double(r) / double(OVERSAMPLE);
+                double sum = 0.0;
+                for (int j = 0; j < KERNEL_LENGTH; ++j) {
+                    double x = double(j - ZERO_CROSSINGS) + frac;
+                    double sinc = (x == 0.0) ? 1.0 : std::sin(double(TWO_PI) * cutoff * x) / (double(TWO_PI) * cutoff * x);
+                    // Blackman window over the kernel
+                    double w = 0.5 + 0.5 * (x / double(ZERO_CROSSINGS));
+                    double window = 0.42 - 0.5 * std::cos(double(TWO_PI) * w) + 0.08 * std::cos(2.0 * double(TWO_PI) * w);
+                    double h = 2.0 * cutoff * sinc * window;
+                    taps[r][j] = float(h);
+                    sum += h;
+                }
+                // Every impulse must have the same area or the DC offset would wobble
+                for (int j = 0; j < KERNEL_LENGTH; ++j) {
+                    taps[r][j] = float(double(taps[r][j]) / sum);
+                }
+            }
+        }
+    
+        float taps[OVERSAMPLE + 1][KERNEL_LENGTH];
+};
+
+// Table driven version of the BLIT Oscillator.  Instead of working out the sinc with the
+// sine recurrence and a divide on every sample, each impulse is added into a small buffer
+// from the SincTable once per cycle (32 interpolated taps).  Each output sample is then just
+// a read.  It is a proper band limited impulse train, not one sinc truncated at the midpoint
+// of the cycle, and it runs ZERO_CROSSINGS samples late.  Same interface as Oscillator.
+class BlitTableOscillator {
+    public:
+        float period = 0.0f;
+        float amplitude = 1.0f;
+        float pitchModulation = 1.0f;
+    
+    void reset() {
+        phase = 1.0f;
+        inc = 0.0f;
+        dc = 0.0f;
+        pos = 0;
+        std::memset(buffer, 0, sizeof(buffer));
+    }
+    
+    float nextSample() {
+        phase += inc;
+        if (phase >= 1.0f) {
+            phase -= 1.0f;
+            // How long ago (in samples) the impulse should have happened
+            float frac = (inc > 0.0f) ? phase / inc : 0.0f;
+            // Pick up the new period once per cycle, just like the BLIT
+            float cyclePeriod = period * pitchModulation;
+            inc = 1.0f / cyclePeriod;
+            dc = amplitude * inc;
+            if (phase >= 1.0f) {
+                phase = 0.0f;
+            }
+            addImpulse(frac);
+        }
+        float output = buffer[pos];
+        if (++pos == BUFFER_SIZE - SincTable::KERNEL_LENGTH) {
+            // Slide the part that's still pending back to the start, so the kernel can always
+            // be added with one straight loop
+            std::memmove(buffer, buffer + pos, SincTable::KERNEL_LENGTH * sizeof(float));
+            std::memset(buffer + SincTable::KERNEL_LENGTH, 0, (BUFFER_SIZE - SincTable::KERNEL_LENGTH) * sizeof(float));
+            pos = 0;
+        }
+        return output - dc;
+    }
+    
+    // Phase locks this oscillator half a cycle away from the other one (for PWM)
+    void squareWave(BlitTableOscillator& other, float newPeriod) {
+        if (other.inc > 0.0f) {
+            phase = other.phase + 0.5f;
+            if (phase >= 1.0f) {
+                phase -= 1.0f;
+            }
+            inc = other.inc;
+        } else {
+            phase = 0.5f;
+            inc = 1.0f / newPeriod;
+        }
+        dc = amplitude * inc;
+    }
+    
+    private:
+        static constexpr int BUFFER_SIZE = 128;
+    
+        void addImpulse(float frac) {
+            float r = std::fmin(frac, 0.999f) * float(SincTable::OVERSAMPLE);
+            int i = int(r);
+            float f = r - float(i);
+            const SincTable& table = SincTable::get();
+            const float* a = table.row(i);
+            const float* b = table.row(i + 1);
+            float* dest = buffer + pos;
+            for (int j = 0; j < SincTable::KERNEL_LENGTH; ++j) {
+                dest[j] += amplitude * (a[j] + f * (b[j] - a[j]));
+            }
+        }
+    
+        float phase = 1.0f;
+        float inc = 0.0f;
+        float dc = 0.0f;
+        int pos = 0;
+        float buffer[BUFFER_SIZE] = {};
+};
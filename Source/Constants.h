@@ -3,4 +3,29 @@
 const float PI_OVER_4 = 0.7853981633974483f;
 const float PI = 3.1415926535897932f;
 const float TWO_PI = 6.2831853071795864f;
+const int MAX_VOICES = 8;
 const int LFO_MAX = 32;
+// The synth renders in chunks of at most this many samples (one chunk per modulation update)
+const int BLOCK_SIZE = LFO_MAX;
+// How many modulation updates are computed ahead at a time
+const int MAX_UPDATES = 8;
+// Oscillator engines (the Osc Engine parameter index)
+const int OSC_BLIT = 0;
+const int OSC_POLYBLEP = 1;
+const int OSC_WAVETABLE = 2;
+const int OSC_BLIT_TABLE = 3;
+// LFO waveforms (the LFO Wave parameter index)
+const int LFO_SINE = 0;
+const int LFO_TRIANGLE = 1;
+const int LFO_SAW = 2;
+const int LFO_SAMPLE_HOLD = 3;
+// Noise colours (the Noise Type parameter index)
+const int NOISE_WHITE = 0;
+const int NOISE_PINK = 1;
+const int NOISE_BROWN = 2;
+// Filter models (the Filter Type parameter index)
+const int FILTER_SVF_LP = 0;
+const int FILTER_SVF_BP = 1;
+const int FILTER_SVF_HP = 2;
+const int FILTER_LADDER = 3;
+const int FILTER_LADDER_DRIVE = 4;
@@ -9,6 +9,9 @@
 */
 
 #pragma once
+
+#include <algorithm>
+
 // Corresponds to -80dB; -20Log10(0.0001f)
 const float SILENCE = 0.0001f;// What the multiplier formula looks like
 //decayTime = 2.0
@@ -47,6 +50,16 @@ class Envelope {
             return level;
         }
     
+        // Same as calling nextValue sampleCount times.  Inside a stage the level is a geometric
+        // sequence, level[n] = target + multiplier^n * (level - target), so each group of 8
+        // samples is one multiply-add with the powers of the multiplier
+        void renderBlock(float* out, int sampleCount) {
+            int i = 0;
+            while (i < sampleCount) {
+                i += renderStage(out + i, sampleCount - i);
+            }
+        }
+    
         inline bool isActive() const noexcept {
             return level > SILENCE;
         }
@@ -65,4 +78,40 @@ class Envelope {
             target = 0.0f;
             multiplier = releaseMultiplier;
         }
+    
+    private:
+        static constexpr int POWERS = 8;
+    
+        // Renders until the end of the block or the end of the attack, returns the number of samples
+        int renderStage(float* out, int sampleCount) {
+            // In double, otherwise the rounding in the powers builds up over a long attack and
+            // moves the start of the decay by a sample or two
+            double powers[POWERS];
+            powers[0] = double(multiplier);
+            for (int j = 1; j < POWERS; ++j) {
+                powers[j] = powers[j - 1] * double(multiplier);
+            }
+            const bool attacking = isInAttackStage();
+            double distance = double(level) - double(target);
+            for (int i = 0; i < sampleCount; i += POWERS) {
+                const int count = std::min(POWERS, sampleCount - i);
+                for (int j = 0; j < count; ++j) {
+                    out[i + j] = float(double(target) + powers[j] * distance);
+                }
+                if (attacking) {
+                    // The decay starts on the sample after the one that crossed (see nextValue)
+                    for (int j = 0; j < count; ++j) {
+                        if (out[i + j] + target > 3.0f) {
+                            level = out[i + j];
+                            multiplier = decayMultiplier;
+                            target = sustainLevel;
+                            return i + j + 1;
+                        }
+                    }
+                }
+                distance *= powers[count - 1];
+            }
+            level = out[sampleCount - 1];
+            return sampleCount;
+        }
 };
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "Constants.h"
+#include "FilterCoefficientTable.h"
 
 class Filter {
     private:
@@ -30,6 +31,15 @@ class Filter {
         a3 = g * a2;
     }
     
+    // Same as above, but looked up in the table (cutoff and Q are log2).  k is 1 / Q,
+    // the resonance only changes once per block so the caller works it out
+    void updateCoefficients(const FilterCoefficientTable& table, float log2Cutoff, float log2Q, float k_) {
+        table.lookup(log2Cutoff, log2Q, g, a1);
+        k = k_;
+        a2 = g * a1;
+        a3 = g * a2;
+    }
+    
     void reset() {
         g = 0.0f;
         k = 0.0f;
@@ -40,12 +50,20 @@ class Filter {
         ic2eq = 0.0f;
     }
     
-    float render(float x) {
+    // mode picks the output: FILTER_SVF_LP, FILTER_SVF_BP or FILTER_SVF_HP
+    float render(float x, int mode = FILTER_SVF_LP) {
         float v3 = x - ic2eq;
         float v1 = a1 * ic1eq + a2 * v3;
         float v2 = ic2eq + a2 * ic1eq + a3 * v3;
         ic1eq = 2.0f * v1 - ic1eq;
         ic2eq = 2.0f * v2 - ic2eq;
-        return v2;
+        switch (mode) {
+            case FILTER_SVF_BP:
+                return v1;
+            case FILTER_SVF_HP:
+                return x - k * v1 - v2;
+            default:
+                return v2;
+        }
     }
 };
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    FilterCoefficientTable.h
+    Created: 20 Oct 2026 2:15:44pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "Constants.h"
+
+// Precomputed SVF coefficients, so the filter doesn't need a tan and three divisions on
+// every modulation update.  g only depends on the cutoff, so it gets a 1D table.  a1 depends
+// on both, so it gets a 2D table (log2 cutoff x log2 Q), and a2 and a3 are worked out from
+// those with two multiplies.  Everything is linearly interpolated.
+//
+// Accuracy against the exact formulas, over the whole cutoff and Q range:
+//   cutoff: within 0.8 cents below 0.4 fs, and 1.8 cents right up to 20kHz at 44.1kHz
+//   a1: within 0.7% at 44.1kHz (the worst case is right by Nyquist), 0.16% at 48kHz, 0.05% at 96kHz and up
+// The tables take about 40KB.  Bench/BenchFilters.cpp measures all of this.
+class FilterCoefficientTable {
+    public:
+        // 7.5 Hz is 30 Hz with 4x oversampling
+        static constexpr float MIN_CUTOFF = 7.5f;
+        static constexpr float MAX_CUTOFF = 20000.0f;
+        static constexpr int CUTOFF_STEPS_PER_OCTAVE = 32;
+        // Q goes from 1 (no resonance) to e^3, about 20 (100% Reso).  A mapped CC only moves
+        // the Reso parameter, it can't go past that
+        static constexpr float MIN_Q = 0.5f;
+        static constexpr float MAX_Q = 32.0f;
+        static constexpr int Q_STEPS_PER_OCTAVE = 4;
+    
+        // Not real-time safe, call from allocateResources
+        void build(float sampleRate) {
+            if (sampleRate == builtSampleRate) {
+                return;
+            }
+            builtSampleRate = sampleRate;
+            minLogCutoff = std::log2(MIN_CUTOFF);
+            minLogQ = std::log2(MIN_Q);
+            rows = int(std::ceil((std::log2(MAX_CUTOFF) - minLogCutoff) * CUTOFF_STEPS_PER_OCTAVE)) + 2;
+            columns = int(std::ceil((std::log2(MAX_Q) - minLogQ) * Q_STEPS_PER_OCTAVE)) + 2;
+            gTable.assign(size_t(rows), 0.0f);
+            a1Table.assign(size_t(rows * columns), 0.0f);
+            for (int r = 0; r < rows; ++r) {
+                double cutoff = std::exp2(double(minLogCutoff) + double(r) / CUTOFF_STEPS_PER_OCTAVE);
+                // Keep it just under Nyquist (only the padding row can get there)
+                cutoff = std::min(cutoff, 0.49 * double(sampleRate));
+                double g = std::tan(double(PI) * cutoff / double(sampleRate));
+                gTable[size_t(r)] = float(g);
+                for (int c = 0; c < columns; ++c) {
+                    double k = 1.0 / std::exp2(double(minLogQ) + double(c) / Q_STEPS_PER_OCTAVE);
+                    a1Table[size_t(r * columns + c)] = float(1.0 / (1.0 + g * (g + k)));
+                }
+            }
+        }
+    
+        // Returns g and a1, the rest of the coefficients follow from these
+        inline void lookup(float log2Cutoff, float log2Q, float& g, float& a1) const noexcept {
+            float x = (log2Cutoff - minLogCutoff) * float(CUTOFF_STEPS_PER_OCTAVE);
+            float y = (log2Q - minLogQ) * float(Q_STEPS_PER_OCTAVE);
+            x = std::clamp(x, 0.0f, float(rows - 2));
+            y = std::clamp(y, 0.0f, float(columns - 2));
+            int r = int(x);
+            int c = int(y);
+            float fx = x - float(r);
+            float fy = y - float(c);
+            
+            g = gTable[size_t(r)] + fx * (gTable[size_t(r + 1)] - gTable[size_t(r)]);
+            
+            const float* row0 = &a1Table[size_t(r * columns + c)];
+            const float* row1 = row0 + columns;
+            float a1Low = row0[0] + fy * (row0[1] - row0[0]);
+            float a1High = row1[0] + fy * (row1[1] - row1[0]);
+            a1 = a1Low + fx * (a1High - a1Low);
+        }
+    
+        // Only g, for filters that work out the rest themselves
+        inline float lookupG(float log2Cutoff) const noexcept {
+            float x = (log2Cutoff - minLogCutoff) * float(CUTOFF_STEPS_PER_OCTAVE);
+            x = std::clamp(x, 0.0f, float(rows - 2));
+            int r = int(x);
+            float fx = x - float(r);
+            return gTable[size_t(r)] + fx * (gTable[size_t(r + 1)] - gTable[size_t(r)]);
+        }
+    
+    private:
+        float builtSampleRate = 0.0f;
+        float minLogCutoff = 0.0f;
+        float minLogQ = 0.0f;
+        int rows = 0;
+        int columns = 0;
+        std::vector<float> gTable;
+        std::vector<float> a1Table;
+};
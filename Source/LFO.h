@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    LFO.h
+    Created: 19 Oct 2026 6:02:37pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include "Constants.h"
+
+// Phase accumulator LFO, evaluated at control rate (once every LFO_MAX samples).
+// The sine comes from a small table, the other shapes are worked out from the phase.
+// All of the waveforms go from -1 to 1 and start at 0 (except S&H).
+class LFO {
+    public:
+        static constexpr int TABLE_SIZE = 256;
+
+        int waveform = LFO_SINE;
+        // In cycles per update
+        float inc = 0.0f;
+
+        LFO() : sineTable(SineTable::get().values) {}
+
+        void reset() {
+            phase = 0.0f;
+            heldValue = 0.0f;
+            seed = 22222;
+        }
+
+        // Writes the next count control rate values
+        void renderBlock(float* out, int count) {
+            for (int i = 0; i < count; ++i) {
+                phase += inc;
+                if (phase >= 1.0f) {
+                    phase -= 1.0f;
+                    // Pick a new value once per cycle
+                    seed = seed * 196314165 + 907633515;
+                    heldValue = float(int(seed >> 7) - 16777216) / 16777216.0f;
+                }
+                out[i] = valueAt(phase);
+            }
+        }
+
+    private:
+        // One table for every LFO in the process, it never changes
+        struct SineTable {
+            float values[TABLE_SIZE + 1];
+
+            static const SineTable& get() {
+                static const SineTable table;
+                return table;
+            }
+
+            SineTable() {
+                for (int i = 0; i <= TABLE_SIZE; ++i) {
+                    values[i] = float(std::sin(double(TWO_PI) * double(i) / double(TABLE_SIZE)));
+                }
+            }
+        };
+
+        const float* sineTable;
+        float phase;
+        float heldValue;
+        unsigned int seed;
+
+        inline float valueAt(float p) const {
+            switch (waveform) {
+                case LFO_TRIANGLE: {
+                    float t = p + 0.75f;
+                    t -= float(int(t));
+                    return 4.0f * std::abs(t - 0.5f) - 1.0f;
+                }
+                case LFO_SAW: {
+                    float t = p + 0.5f;
+                    t -= float(int(t));
+                    return 2.0f * t - 1.0f;
+                }
+                case LFO_SAMPLE_HOLD:
+                    return heldValue;
+                default: {
+                    float x = p * float(TABLE_SIZE);
+                    int i = int(x);
+                    float frac = x - float(i);
+                    return sineTable[i] + frac * (sineTable[i + 1] - sineTable[i]);
+                }
+            }
+        }
+};
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    LadderFilter.h
+    Created: 19 Oct 2026 3:41:12pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include "Constants.h"
+#include "FilterCoefficientTable.h"
+
+// 4-pole (24dB) ladder, built from four TPT one-poles with zero delay feedback.
+// It has the same interface as Filter, so Voice can drive either one.
+//
+// Linear mode solves the feedback loop exactly. In nonlinear mode a tanh sits
+// at the input of the ladder, so the loop has no closed-form solution. It is
+// solved with a fixed number of Newton steps, starting from the linear answer,
+// which keeps the cost the same on every sample.
+//
+// Cost per voice, from Bench/BenchFilters.cpp (8 voices, -O3, x86-64):
+//                  render (per sample)   exact update and one sample
+//   SVF LP/BP/HP   ~2.5 ns               ~17 ns
+//   Ladder         ~7 ns                 ~26 ns
+//   Ladder Drive   ~26 ns                ~58 ns
+// The filter oversampling multiplies the render cost by 2 or 4.  Two Newton steps
+// get within 1e-6 of the fully converged answer.
+class LadderFilter {
+    public:
+    static constexpr int SOLVER_ITERATIONS = 2;
+    // k = 4 is where the linear ladder starts to self oscillate (and blow up)
+    static constexpr float MAX_RESONANCE = 3.95f;
+
+    float sampleRate;
+    bool nonlinear = false;
+
+    void updateCoefficients(float cutoff, float Q) {
+        setCoefficients(std::tan(PI * cutoff / sampleRate), Q);
+    }
+
+    // Same as above, but g is looked up in the table (the cutoff is log2, Q isn't)
+    void updateCoefficients(const FilterCoefficientTable& table, float log2Cutoff, float Q) {
+        setCoefficients(table.lookupG(log2Cutoff), Q);
+    }
+
+    void reset() {
+        G = 0.0f;
+        b = 1.0f;
+        k = 0.0f;
+        kG4 = 0.0f;
+        a = 1.0f;
+        gain = 1.0f;
+        s1 = 0.0f;
+        s2 = 0.0f;
+        s3 = 0.0f;
+        s4 = 0.0f;
+    }
+
+    float render(float x) {
+        // What the output would be with no input, from the stage states
+        float S = b * (s4 + G * (s3 + G * (s2 + G * s1)));
+        // Boost the input so the passband doesn't drop as the resonance goes up
+        float c = gain * x - k * S;
+        // The linear solution of u = c - k * y4, with y4 = G^4 * u + S
+        float u = c * a;
+        if (nonlinear) {
+            // Solve u = tanh(c - kG4 * u)
+            for (int i = 0; i < SOLVER_ITERATIONS; ++i) {
+                float t = fastTanh(c - kG4 * u);
+                u -= (u - t) / (1.0f + kG4 * (1.0f - t * t));
+            }
+        }
+        float y1 = stage(u, s1);
+        float y2 = stage(y1, s2);
+        float y3 = stage(y2, s3);
+        return stage(y3, s4);
+    }
+
+    private:
+    // filter coeffs
+    float G, b, k, kG4, a, gain;
+    // internal state:
+    float s1, s2, s3, s4;
+
+    void setCoefficients(float g, float Q) {
+        G = g / (1.0f + g);
+        b = 1.0f / (1.0f + g);
+        // Q = 1 (no resonance) is k = 0, the Q of 20 at 100% Reso is k = 3.8
+        k = std::clamp(4.0f - 4.0f / Q, 0.0f, MAX_RESONANCE);
+        float G2 = G * G;
+        kG4 = k * G2 * G2;
+        a = 1.0f / (1.0f + kG4);
+        gain = 1.0f + k;
+    }
+
+    // TPT one-pole lowpass
+    inline float stage(float x, float& s) {
+        float v = G * (x - s);
+        float y = v + s;
+        s = y + v;
+        return y;
+    }
+
+    // Rational approximation, exact at 0 and reaches +/-1 at +/-3
+    static inline float fastTanh(float x) {
+        x = std::clamp(x, -3.0f, 3.0f);
+        float x2 = x * x;
+        return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+    }
+};
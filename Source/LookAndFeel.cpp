@@ -10,6 +10,12 @@
 
 #include "LookAndFeel.h"
 
+// Loading the font parses the whole file, so every editor shares the one copy
+static juce::Typeface::Ptr getLatoTypeface() {
+    static juce::Typeface::Ptr typeface = juce::Typeface::createSystemTypefaceFor(BinaryData::LatoMedium_ttf, BinaryData::LatoMedium_ttfSize);
+    return typeface;
+}
+
 LookAndFeel::LookAndFeel() {
     setColour(juce::ResizableWindow::backgroundColourId, juce::Colour(30, 60, 90));
     
@@ -24,21 +30,68 @@ LookAndFeel::LookAndFeel() {
     setColour(juce::TextButton::textColourOnId, juce::Colour(255, 255, 255));
     setColour(juce::ComboBox::outlineColourId, juce::Colour(180, 180, 180));
     // Get the Lato font (be sure to include it!)
-    juce::Typeface::Ptr typeface = juce::Typeface::createSystemTypefaceFor(BinaryData::LatoMedium_ttf, BinaryData::LatoMedium_ttfSize);
-    setDefaultSansSerifTypeface(typeface);
+    setDefaultSansSerifTypeface(getLatoTypeface());
     
 }
 
+// The knob's area within a square of the given width, at (0, 0)
+static juce::Rectangle<float> knobBounds(int width) {
+    return juce::Rectangle<int>(0, 0, width, width).toFloat() .withTrimmedLeft(16.0f).withTrimmedRight(16.0f) .withTrimmedTop(0.0f).withTrimmedBottom(8.0f);
+}
+
+static constexpr float knobLineWidth = 6.0f;
+
+const juce::Image& LookAndFeel::getKnobBackground(int width, float scale, float startAngle, float endAngle, juce::Colour colour) {
+    ++knobBackgroundUses;
+    for (auto& background : knobBackgrounds) {
+        if (background.width == width && background.scale == scale && background.startAngle == startAngle
+            && background.endAngle == endAngle && background.colour == colour) {
+            background.lastUsed = knobBackgroundUses;
+            return background.image;
+        }
+    }
+    if (knobBackgrounds.size() >= MAX_KNOB_BACKGROUNDS) {
+        knobBackgrounds.erase(std::min_element(knobBackgrounds.begin(), knobBackgrounds.end(),
+            [](const KnobBackground& a, const KnobBackground& b) { return a.lastUsed < b.lastUsed; }));
+    }
+    // At the physical resolution, so it's as sharp as drawing the arc directly
+    const int size = juce::roundToInt(std::ceil(float(width) * scale));
+    juce::Image image(juce::Image::ARGB, size, size, true);
+    {
+        juce::Graphics ig(image);
+        ig.addTransform(juce::AffineTransform::scale(scale));
+        auto bounds = knobBounds(width);
+        auto center = bounds.getCentre();
+        auto arcRadius = bounds.getWidth() / 2.0f - knobLineWidth / 2.0f;
+        juce::Path backgroundArc;
+        backgroundArc.addCentredArc(center.x, center.y, arcRadius, arcRadius, 0.0f, startAngle, endAngle, true);
+        ig.setColour(colour);
+        ig.strokePath(backgroundArc, juce::PathStrokeType(knobLineWidth, juce::PathStrokeType::curved, juce::PathStrokeType::butt));
+    }
+    knobBackgrounds.push_back({ width, scale, startAngle, endAngle, colour, image, knobBackgroundUses });
+    return knobBackgrounds.back().image;
+}
+
 void LookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int /*height*/, float sliderPos, float rotaryStartAngle, float rotaryEndAngle, juce::Slider& slider) {
+    const auto start = juce::Time::getHighResolutionTicks();
         auto outlineColor = slider.findColour(juce::Slider::rotarySliderOutlineColourId);
     auto fillColor = slider.findColour(juce::Slider::rotarySliderFillColourId);
     auto dialColor = slider.findColour(juce::Slider::thumbColourId);
     
-    auto bounds = juce::Rectangle<int>(x, y, width, width).toFloat() .withTrimmedLeft(16.0f).withTrimmedRight(16.0f) .withTrimmedTop(0.0f).withTrimmedBottom(8.0f);
+    // An opaque slider (see RotaryKnob) fills in its own background, so a new value
+    // only repaints the slider and not the knob and the editor behind it
+    if (slider.isOpaque()) {
+        g.fillAll(slider.findColour(juce::ResizableWindow::backgroundColourId));
+    }
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    g.drawImage(getKnobBackground(width, scale, rotaryStartAngle, rotaryEndAngle, outlineColor),
+                juce::Rectangle<int>(x, y, width, width).toFloat());
+    
+    auto bounds = knobBounds(width).translated(float(x), float(y));
     
     auto radius = bounds.getWidth() / 2.0f;
     auto toAngle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
-    auto lineW = 6.0f;
+    auto lineW = knobLineWidth;
     auto arcRadius = radius - lineW / 2.0f;
     
     auto arg = toAngle - juce::MathConstants<float>::halfPi;
@@ -46,10 +99,7 @@ void LookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, i
     auto dialRadius = arcRadius - 6.0f;
     
     auto center = bounds.getCentre();
-    auto strokeType = juce::PathStrokeType(lineW, juce::PathStrokeType::curved, juce::PathStrokeType::butt);  juce::Path backgroundArc;
-    backgroundArc.addCentredArc(center.x, center.y, arcRadius, arcRadius, 0.0f, rotaryStartAngle, rotaryEndAngle, true);
-    g.setColour(outlineColor);
-    g.strokePath(backgroundArc, strokeType);
+    auto strokeType = juce::PathStrokeType(lineW, juce::PathStrokeType::curved, juce::PathStrokeType::butt);
     
     if (slider.isEnabled()) {
         juce::Path valueArc;
@@ -65,4 +115,5 @@ void LookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, i
     g.drawLine(center.x, center.y, thumbPoint.x, thumbPoint.y, dialW);
     g.fillEllipse(juce::Rectangle<float>(dialW, dialW).withCentre(thumbPoint));
     g.fillEllipse(juce::Rectangle<float>(dialW, dialW).withCentre(center));
+    knobPaintMilliseconds += 1000.0 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
 }
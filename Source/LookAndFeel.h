@@ -14,7 +14,28 @@
 class LookAndFeel : public juce::LookAndFeel_V4 {
     public:
         LookAndFeel();
+        // The background arc comes from a cached image, only the value arc and the dial
+        // are drawn each time
         void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPos, float rotaryStartAngle, float rotaryEndAngle, juce::Slider& slider) override;
+        // How long drawRotarySlider has taken since the last call, for the editor's status line
+        double takeKnobPaintMilliseconds() {
+            return std::exchange(knobPaintMilliseconds, 0.0);
+        }
     private:
+        // One per knob size, colour and display scale.  When it's full the least recently
+        // used one goes, so a few odd knobs can't push out the ones on screen
+        struct KnobBackground {
+            int width;
+            float scale;
+            float startAngle, endAngle;
+            juce::Colour colour;
+            juce::Image image;
+            uint32_t lastUsed;
+        };
+        static constexpr size_t MAX_KNOB_BACKGROUNDS = 16;
+        std::vector<KnobBackground> knobBackgrounds;
+        uint32_t knobBackgroundUses = 0;
+        double knobPaintMilliseconds = 0.0;
+        const juce::Image& getKnobBackground(int width, float scale, float startAngle, float endAngle, juce::Colour colour);
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LookAndFeel)
 };
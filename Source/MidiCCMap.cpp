@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    MidiCCMap.cpp
+    Created: 20 Oct 2026 1:02:37am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include "MidiCCMap.h"
+
+MidiCCMap::MidiCCMap() {
+    current.store(new Table());
+    active = current.load();
+}
+
+MidiCCMap::~MidiCCMap() {
+    // The audio has stopped by now
+    delete current.load();
+}
+
+MidiCCMap::Mapping MidiCCMap::get(int cc) const {
+    std::lock_guard<std::mutex> guard(lock);
+    return current.load()->entries[cc & 0x7F];
+}
+
+void MidiCCMap::getAll(Mapping (&mappings)[NUM_CCS]) const {
+    std::lock_guard<std::mutex> guard(lock);
+    const Table* table = current.load();
+    std::copy(table->entries, table->entries + NUM_CCS, mappings);
+}
+
+void MidiCCMap::set(int cc, const Mapping& mapping) {
+    if (cc < 0 || cc >= FIRST_MODE_MESSAGE) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    auto table = std::make_unique<Table>(*current.load());
+    table->entries[cc] = mapping;
+    publish(std::move(table));
+}
+
+void MidiCCMap::remove(int cc) {
+    set(cc, Mapping());
+}
+
+void MidiCCMap::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    publish(std::make_unique<Table>());
+}
+
+void MidiCCMap::setAll(const Mapping (&mappings)[NUM_CCS]) {
+    auto table = std::make_unique<Table>();
+    std::copy(mappings, mappings + FIRST_MODE_MESSAGE, table->entries);
+    std::lock_guard<std::mutex> guard(lock);
+    publish(std::move(table));
+}
+
+void MidiCCMap::publish(std::unique_ptr<Table> table) {
+    const Table* old = current.exchange(table.release());
+    // If the audio thread picked up the old table, it has let go of it by the time
+    // the count goes past this
+    retired.push_back({ std::unique_ptr<const Table>(old), blocksDone.load() });
+    freeRetired();
+}
+
+void MidiCCMap::collectGarbage() {
+    std::lock_guard<std::mutex> guard(lock);
+    freeRetired();
+}
+
+void MidiCCMap::freeRetired() {
+    const uint64_t done = blocksDone.load();
+    retired.erase(std::remove_if(retired.begin(), retired.end(),
+                                 [done](const Retired& r) { return done > r.blocksAtSwap; }),
+                  retired.end());
+}
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    MidiCCMap.h
+    Created: 20 Oct 2026 1:02:37am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Routes MIDI CCs to parameters.  The audio thread looks a CC up in a 128 entry
+// table, which is one load and an index.  The other threads never change a table
+// the audio thread can see: they change a copy and swap the pointer.  The old table
+// is freed once the audio thread has finished a block since the swap, so the audio
+// thread never locks, allocates or frees anything.  The other threads (the message
+// thread, and the host saving or loading the state from wherever it likes) share a
+// lock, so a table can't be freed while one of them is still reading it.
+class MidiCCMap {
+    public:
+        static constexpr int NUM_CCS = 128;
+        // 120 and up are the channel mode messages (All Notes Off and so on), those
+        // can't be mapped
+        static constexpr int FIRST_MODE_MESSAGE = 120;
+
+        enum Curve : uint8_t {
+            CURVE_LINEAR,
+            CURVE_EXPONENTIAL,  // Fine control at the bottom, like a cutoff knob wants
+            CURVE_LOGARITHMIC,  // Fine control at the top
+            NUM_CURVES
+        };
+
+        struct Mapping {
+            int parameter = -1;         // Index into AudioProcessor::getParameters(), -1 is not mapped
+            float rangeStart = 0.0f;    // Normalised parameter values for CC 0 and CC 127,
+            float rangeEnd = 1.0f;      // the end can be below the start to turn it around
+            Curve curve = CURVE_LINEAR;
+
+            bool isMapped() const noexcept { return parameter >= 0; }
+            // The normalised parameter value for a CC value
+            float apply(uint8_t value) const noexcept {
+                float x = float(value) / 127.0f;
+                if (curve == CURVE_EXPONENTIAL) {
+                    x *= x;
+                } else if (curve == CURVE_LOGARITHMIC) {
+                    x = 1.0f - (1.0f - x) * (1.0f - x);
+                }
+                return rangeStart + x * (rangeEnd - rangeStart);
+            }
+        };
+
+        MidiCCMap();
+        ~MidiCCMap();
+
+        // Audio thread.  Every block that looks anything up has to be between a
+        // beginBlock() and an endBlock()
+        void beginBlock() noexcept { active = current.load(); }
+        void endBlock() noexcept { blocksDone.fetch_add(1); }
+        const Mapping& lookup(uint8_t cc) const noexcept { return active->entries[cc & 0x7F]; }
+
+        // Any thread but the audio thread
+        Mapping get(int cc) const;
+        // Every CC at once, so they all come from the same table
+        void getAll(Mapping (&mappings)[NUM_CCS]) const;
+        void set(int cc, const Mapping& mapping);
+        void remove(int cc);
+        void clear();
+        // Maps the CCs in the array, unmaps the rest.  For loading the state
+        void setAll(const Mapping (&mappings)[NUM_CCS]);
+        // Frees the tables the audio thread is done with, call it from a timer
+        void collectGarbage();
+
+    private:
+        struct Table {
+            Mapping entries[NUM_CCS];
+        };
+        std::atomic<const Table*> current { nullptr };
+        // Audio thread, the table for this block
+        const Table* active = nullptr;
+        std::atomic<uint64_t> blocksDone { 0 };
+        // Held by everything but the audio thread
+        mutable std::mutex lock;
+        // Tables that were swapped out and the block count at the time
+        struct Retired {
+            std::unique_ptr<const Table> table;
+            uint64_t blocksAtSwap;
+        };
+        std::vector<Retired> retired;
+
+        // With the lock held
+        void publish(std::unique_ptr<Table> table);
+        void freeRetired();
+
+        MidiCCMap(const MidiCCMap&) = delete;
+        MidiCCMap& operator=(const MidiCCMap&) = delete;
+};
@@ -9,22 +9,107 @@
 */
 
 #pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include "Constants.h"
+
 class NoiseGenerator {
     public:
-        void reset() {
-            noiseSeed = 22222;
+        // Independent xorshift generators, each one fills every LANES-th sample of a block
+        static constexpr int LANES = 8;
+
+        // Different seeds give streams that aren't correlated with each other
+        void reset(unsigned int seed = 22222) {
+            noiseSeed = seed;
+            // Seed the lanes from the LCG, xorshift gets stuck on zero
+            unsigned int s = seed;
+            for (int j = 0; j < LANES; ++j) {
+                s = s * 196314165 + 907633515;
+                lanes[j] = (s == 0) ? 1 : s;
+            }
+            pink0 = 0.0f;
+            pink1 = 0.0f;
+            pink2 = 0.0f;
+            brown = 0.0f;
         }
-        float nextValue() {
-            // Generate the next integer pseudorandom number
-            noiseSeed = noiseSeed * 196314165 + 907633515;
-            
-            // convert to a signed value
-            int temp = int(noiseSeed >> 7) - 16777216;
-            
-            // Convert to a floating-point number between -1.0 and 1.0
-            return float(temp) / 16777216.0f;
+
+        // Fills out with sampleCount samples of NOISE_WHITE, NOISE_PINK or NOISE_BROWN noise.
+        // original is the white noise from before SOUND_VERSION_NOISE
+        void fillBlock(float* out, int sampleCount, int type, bool original = false) {
+            if (original) {
+                fillOriginal(out, sampleCount);
+            } else {
+                fillWhite(out, sampleCount);
+            }
+            if (type == NOISE_PINK) {
+                pinkFilter(out, sampleCount);
+            } else if (type == NOISE_BROWN) {
+                brownFilter(out, sampleCount);
+            }
         }
-        
+
     private:
         unsigned int noiseSeed;
+        uint32_t lanes[LANES];
+        float pink0, pink1, pink2;
+        float brown;
+
+        // White noise between -1.0 and 1.0.  The lanes don't depend on each other, so the
+        // compiler turns each step into a couple of vector instructions
+        void fillWhite(float* out, int sampleCount) {
+            for (int i = 0; i < sampleCount; i += LANES) {
+                float values[LANES];
+                for (int j = 0; j < LANES; ++j) {
+                    uint32_t x = lanes[j];
+                    x ^= x << 13;
+                    x ^= x >> 17;
+                    x ^= x << 5;
+                    lanes[j] = x;
+                    values[j] = float(int32_t(x)) * (1.0f / 2147483648.0f);
+                }
+                const int count = std::min(LANES, sampleCount - i);
+                for (int j = 0; j < count; ++j) {
+                    out[i + j] = values[j];
+                }
+            }
+        }
+
+        // The original generator, one LCG step per sample.  Each step depends on the one
+        // before, so it can't be vectorised
+        void fillOriginal(float* out, int sampleCount) {
+            for (int i = 0; i < sampleCount; ++i) {
+                // Generate the next integer pseudorandom number
+                noiseSeed = noiseSeed * 196314165 + 907633515;
+
+                // convert to a signed value
+                int temp = int(noiseSeed >> 7) - 16777216;
+
+                // Convert to a floating-point number between -1.0 and 1.0
+                out[i] = float(temp) / 16777216.0f;
+            }
+        }
+
+        // Paul Kellet's economy filter, -3dB per octave to within about 0.5dB above 40Hz (at 44.1k).
+        // The gain brings it back to about the same loudness as the white noise
+        void pinkFilter(float* buffer, int sampleCount) {
+            for (int i = 0; i < sampleCount; ++i) {
+                float white = buffer[i];
+                pink0 = 0.99765f * pink0 + white * 0.0990460f;
+                pink1 = 0.96300f * pink1 + white * 0.2965164f;
+                pink2 = 0.57000f * pink2 + white * 1.0526913f;
+                buffer[i] = (pink0 + pink1 + pink2 + white * 0.1848f) * PINK_GAIN;
+            }
+        }
+
+        // Leaky integrator, -6dB per octave above about 35Hz
+        void brownFilter(float* buffer, int sampleCount) {
+            for (int i = 0; i < sampleCount; ++i) {
+                brown = 0.995f * brown + buffer[i] * BROWN_GAIN;
+                buffer[i] = brown;
+            }
+        }
+
+        static constexpr float PINK_GAIN = 0.33f;
+        static constexpr float BROWN_GAIN = 0.1f;
 };
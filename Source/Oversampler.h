@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+    Oversampler.h
+    Created: 20 Oct 2026 9:48:31am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "Constants.h"
+
+// Half-band lowpass for 2x up/downsampling.  Every other tap of a half-band filter is zero
+// except the centre one (which is 0.5), so only the TAPS non-zero ones are stored.  Built
+// once and shared by every voice of every instance.
+class HalfBandCoefficients {
+    public:
+        static constexpr int TAPS = 20;                     // 2 * TAPS - 1 = 39 tap filter
+        static constexpr int CENTRE = TAPS / 2 - 1;         // delay of the centre tap, in low rate samples
+
+        static const HalfBandCoefficients& get() {
+            static const HalfBandCoefficients coefficients;
+            return coefficients;
+        }
+
+        // The non-zero taps, already doubled to make up for the zero stuffing when upsampling
+        float taps[TAPS];
+
+    private:
+        HalfBandCoefficients() {
+            // Kaiser windowed sinc at a quarter of the (oversampled) rate.  Flat to 0.375 of the
+            // low rate (18kHz at 48kHz) and better than -85dB by 0.625
+            const double beta = 8.0;
+            const double norm = besselI0(beta);
+            for (int k = 0; k < TAPS; ++k) {
+                // Tap 2k of the full filter is an odd number of samples from the centre, so never 0
+                double x = double(2 * k - (TAPS - 1));
+                double sinc = std::sin(double(PI) * 0.5 * x) / (double(PI) * x);
+                double r = x / double(TAPS);
+                double window = besselI0(beta * std::sqrt(1.0 - r * r)) / norm;
+                taps[k] = float(2.0 * sinc * window);
+            }
+        }
+
+        static double besselI0(double x) {
+            double sum = 1.0;
+            double term = 1.0;
+            for (int k = 1; k < 32; ++k) {
+                double t = x / (2.0 * double(k));
+                term *= t * t;
+                sum += term;
+            }
+            return sum;
+        }
+};
+
+// One 2x stage.  Polyphase, so the filter only ever runs on the samples that aren't zero:
+// upsampling is one TAPS long dot product plus a delayed copy, and so is downsampling.  The
+// histories are stored twice so the dot products run over contiguous memory and vectorise.
+class HalfBandStage {
+    public:
+        void reset() {
+            std::memset(upHistory, 0, sizeof(upHistory));
+            std::memset(evenHistory, 0, sizeof(evenHistory));
+            std::memset(oddHistory, 0, sizeof(oddHistory));
+            upPos = 0;
+            downPos = 0;
+        }
+
+        // One sample in, two out (with a gain of 2 to make up for the zero stuffing)
+        inline void upsample(float x, float& out0, float& out1) noexcept {
+            upPos = previous(upPos);
+            upHistory[upPos] = x;
+            upHistory[upPos + HalfBandCoefficients::TAPS] = x;
+            out0 = dot(upHistory + upPos);
+            out1 = upHistory[upPos + HalfBandCoefficients::CENTRE];
+        }
+
+        // Two samples in, one out
+        inline float downsample(float in0, float in1) noexcept {
+            downPos = previous(downPos);
+            evenHistory[downPos] = in0;
+            evenHistory[downPos + HalfBandCoefficients::TAPS] = in0;
+            oddHistory[downPos] = in1;
+            oddHistory[downPos + HalfBandCoefficients::TAPS] = in1;
+            // The taps are doubled for upsampling, so halve them again here
+            return 0.5f * (dot(evenHistory + downPos) + oddHistory[downPos + HalfBandCoefficients::CENTRE + 1]);
+        }
+
+        // For the up and down filters together, in samples at the lower of the two rates
+        static constexpr int LATENCY = HalfBandCoefficients::TAPS - 1;
+
+    private:
+        static inline int previous(int pos) noexcept {
+            return (pos == 0) ? HalfBandCoefficients::TAPS - 1 : pos - 1;
+        }
+
+        inline float dot(const float* x) const noexcept {
+            const float* h = taps;
+            float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+            for (int k = 0; k < HalfBandCoefficients::TAPS; k += 4) {
+                s0 += h[k] * x[k];
+                s1 += h[k + 1] * x[k + 1];
+                s2 += h[k + 2] * x[k + 2];
+                s3 += h[k + 3] * x[k + 3];
+            }
+            return (s0 + s1) + (s2 + s3);
+        }
+
+        // Looked up once when the stage is made, get() has a guard check on every call
+        const float* taps = HalfBandCoefficients::get().taps;
+        float upHistory[2 * HalfBandCoefficients::TAPS];
+        float evenHistory[2 * HalfBandCoefficients::TAPS];
+        float oddHistory[2 * HalfBandCoefficients::TAPS];
+        int upPos = 0;
+        int downPos = 0;
+};
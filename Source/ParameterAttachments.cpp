@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    ParameterAttachments.cpp
+    Created: 20 Oct 2026 2:47:19am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include "ParameterAttachments.h"
+
+ParameterAttachments::ParameterAttachments(juce::AudioProcessorValueTreeState& apvts_) : apvts(apvts_) {
+    startTimerHz(REFRESH_RATE);
+}
+
+ParameterAttachments::~ParameterAttachments() {
+    stopTimer();
+    // The controls can outlive this, so take the callbacks back
+    for (auto& attachment : attachments) {
+        if (attachment.slider != nullptr) {
+            attachment.slider->onValueChange = nullptr;
+            attachment.slider->onDragStart = nullptr;
+            attachment.slider->onDragEnd = nullptr;
+        }
+        if (attachment.button != nullptr) {
+            attachment.button->onClick = nullptr;
+        }
+        if (attachment.comboBox != nullptr) {
+            attachment.comboBox->onChange = nullptr;
+        }
+    }
+}
+
+ParameterAttachments::Attachment& ParameterAttachments::add(const juce::ParameterID& id) {
+    auto* parameter = apvts.getParameter(id.getParamID());
+    jassert(parameter != nullptr);
+    Attachment attachment;
+    attachment.parameter = parameter;
+    attachment.shownValue = parameter->getValue();
+    attachments.push_back(attachment);
+    return attachments.back();
+}
+
+void ParameterAttachments::attach(juce::Slider& slider, const juce::ParameterID& id) {
+    const size_t index = attachments.size();
+    Attachment& attachment = add(id);
+    attachment.slider = &slider;
+    auto* parameter = attachment.parameter;
+
+    // The slider works in the parameter's own units, with its skew and steps
+    auto range = parameter->getNormalisableRange();
+    slider.setNormalisableRange(juce::NormalisableRange<double>(
+        double(range.start), double(range.end),
+        [parameter](double, double, double value) { return double(parameter->convertFrom0to1(float(value))); },
+        [parameter](double, double, double value) { return double(parameter->convertTo0to1(float(value))); },
+        [parameter](double, double, double value) {
+            return double(parameter->convertFrom0to1(parameter->convertTo0to1(float(value))));
+        }));
+    slider.textFromValueFunction = [parameter](double value) {
+        return (parameter->getText(parameter->convertTo0to1(float(value)), 0) + " " + parameter->getLabel()).trim();
+    };
+    slider.valueFromTextFunction = [parameter](const juce::String& text) {
+        return double(parameter->convertFrom0to1(parameter->getValueForText(text)));
+    };
+    slider.setDoubleClickReturnValue(true, double(parameter->convertFrom0to1(parameter->getDefaultValue())));
+    showValue(attachment, attachment.shownValue);
+
+    slider.onDragStart = [parameter] { parameter->beginChangeGesture(); };
+    slider.onDragEnd = [parameter] { parameter->endChangeGesture(); };
+    slider.onValueChange = [this, index, &slider] {
+        auto* parameter = attachments[index].parameter;
+        // Typing a value or a double click isn't a drag, so it needs a gesture of its own
+        setParameter(index, parameter->convertTo0to1(float(slider.getValue())), slider.isMouseButtonDown());
+    };
+}
+
+void ParameterAttachments::attach(juce::Button& button, const juce::ParameterID& id) {
+    const size_t index = attachments.size();
+    Attachment& attachment = add(id);
+    attachment.button = &button;
+    button.setClickingTogglesState(true);
+    showValue(attachment, attachment.shownValue);
+    button.onClick = [this, index, &button] {
+        setParameter(index, button.getToggleState() ? 1.0f : 0.0f, false);
+    };
+}
+
+void ParameterAttachments::attach(juce::ComboBox& comboBox, const juce::ParameterID& id) {
+    const size_t index = attachments.size();
+    Attachment& attachment = add(id);
+    attachment.comboBox = &comboBox;
+    comboBox.clear(juce::dontSendNotification);
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(attachment.parameter)) {
+        comboBox.addItemList(choice->choices, 1);
+    }
+    showValue(attachment, attachment.shownValue);
+    comboBox.onChange = [this, index, &comboBox] {
+        auto* parameter = attachments[index].parameter;
+        setParameter(index, parameter->convertTo0to1(float(comboBox.getSelectedItemIndex())), false);
+    };
+}
+
+void ParameterAttachments::setParameter(size_t index, float normalisedValue, bool inGesture) {
+    Attachment& attachment = attachments[index];
+    auto* parameter = attachment.parameter;
+    if (parameter->getValue() != normalisedValue) {
+        if (!inGesture) {
+            parameter->beginChangeGesture();
+        }
+        parameter->setValueNotifyingHost(normalisedValue);
+        if (!inGesture) {
+            parameter->endChangeGesture();
+        }
+    }
+    // What the parameter snapped it to, so the timer doesn't move the control back
+    attachment.shownValue = parameter->getValue();
+}
+
+void ParameterAttachments::showValue(Attachment& attachment, float normalisedValue) {
+    attachment.shownValue = normalisedValue;
+    auto* parameter = attachment.parameter;
+    if (attachment.slider != nullptr) {
+        attachment.slider->setValue(double(parameter->convertFrom0to1(normalisedValue)), juce::dontSendNotification);
+    }
+    if (attachment.button != nullptr) {
+        attachment.button->setToggleState(normalisedValue >= 0.5f, juce::dontSendNotification);
+    }
+    if (attachment.comboBox != nullptr) {
+        attachment.comboBox->setSelectedItemIndex(juce::roundToInt(parameter->convertFrom0to1(normalisedValue)),
+                                                  juce::dontSendNotification);
+    }
+}
+
+void ParameterAttachments::timerCallback() {
+    // Reading the parameters is just atomic loads, the work is in the controls that moved
+    const auto start = juce::Time::getHighResolutionTicks();
+    int updateCount = 0;
+    for (auto& attachment : attachments) {
+        float value = attachment.parameter->getValue();
+        if (value != attachment.shownValue) {
+            showValue(attachment, value);
+            ++updateCount;
+        }
+    }
+    lastUpdateCount = updateCount;
+    lastRefreshMilliseconds = 1000.0 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    ParameterAttachments.h
+    Created: 20 Oct 2026 2:47:19am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Connects the editor's controls to the parameters, like the APVTS attachments, but
+// the parameter to control direction is polled by one timer at the display rate.
+// A parameter that the host automates a thousand times a second still only moves its
+// control REFRESH_RATE times a second, and every control that changed is updated in
+// the same timer callback (so the repaints land in the same frame).  The control to
+// parameter direction is immediate, with begin and end gestures for the host.
+class ParameterAttachments : private juce::Timer {
+    public:
+        static constexpr int REFRESH_RATE = 30;
+
+        explicit ParameterAttachments(juce::AudioProcessorValueTreeState& apvts);
+        ~ParameterAttachments() override;
+
+        void attach(juce::Slider& slider, const juce::ParameterID& id);
+        // A toggle, for a choice with two options (Off/On and so on)
+        void attach(juce::Button& button, const juce::ParameterID& id);
+        // Fills in the items from the parameter's choices
+        void attach(juce::ComboBox& comboBox, const juce::ParameterID& id);
+
+        // How many controls the last refresh moved and how long it took, for measuring
+        // the UI thread's share while the host automates everything
+        int getLastUpdateCount() const noexcept { return lastUpdateCount; }
+        double getLastRefreshMilliseconds() const noexcept { return lastRefreshMilliseconds; }
+
+    private:
+        struct Attachment {
+            juce::RangedAudioParameter* parameter;
+            juce::Slider* slider = nullptr;
+            juce::Button* button = nullptr;
+            juce::ComboBox* comboBox = nullptr;
+            // The normalised value the control shows
+            float shownValue;
+        };
+        juce::AudioProcessorValueTreeState& apvts;
+        // The controls' callbacks hold indices into this, not pointers
+        std::vector<Attachment> attachments;
+        int lastUpdateCount = 0;
+        double lastRefreshMilliseconds = 0.0;
+
+        Attachment& add(const juce::ParameterID& id);
+        void setParameter(size_t index, float normalisedValue, bool inGesture);
+        void showValue(Attachment& attachment, float normalisedValue);
+        void timerCallback() override;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterAttachments)
+};
@@ -9,131 +9,164 @@
 */
 
 #include "Parameters.h"
-#include "Envelope.h"
-#include "Constants.h"
-
-void Parameters::updateParams(float sampleRate) {
-    float inverseSampleRate = 1.0f / sampleRate;
-    const float inverseUpdateRate = inverseSampleRate * LFO_MAX;
-    float lfoRate = std::exp(7.0f * lfoRateParam->get() - 4.0f);
-    float vibratoTemp = vibratoParam->get() / 200.0f;
-    vibratoAmount = 0.2f * vibratoTemp * vibratoTemp;
-    pwmDepth = vibratoAmount;
-    // If the vibrato parameter < 0, then it is used for PWM
-    if (vibratoTemp < 0.0f) {
-        vibratoAmount = 0.0f;
+
+RenderParams Parameters::makeRenderParams(float sampleRate) const {
+    float raw[NUM_PARAMS];
+    getPresetValues(raw);
+    RenderParams renderParams = RenderParams::derive(raw, sampleRate);
+    applyQualitySettings(renderParams);
+    return renderParams;
+}
+
+void Parameters::buildPresetSnapshots(float sampleRate) {
+    presetSnapshots = SharedResources<PresetSnapshots>::get(sampleRate, [sampleRate](PresetSnapshots& snapshots) {
+        // The rest was worked out at compile time
+        snapshots = FACTORY_SNAPSHOTS;
+        for (int i = 0; i < NUM_FACTORY_PRESETS; ++i) {
+            RenderParams::deriveRateDependent(snapshots[size_t(i)], FACTORY_PRESETS[i].param, sampleRate);
+        }
+    });
+}
+
+RenderParams Parameters::presetSnapshot(int index) const {
+    RenderParams renderParams = (*presetSnapshots)[size_t(index)];
+    applyQualitySettings(renderParams);
+    return renderParams;
+}
+
+bool Parameters::isMorphing() const {
+    return currentChoice(table->morphIndex, morphParam) == 1;
+}
+
+float Parameters::getMorphPosition() const {
+    return morphPositionParam->convertFrom0to1(currentValue(table->morphPositionIndex)) / 100.0f;
+}
+
+RenderParams Parameters::makeMorphParams(float position, float sampleRate) const {
+    const float* a = FACTORY_PRESETS[currentChoice(table->morphAIndex, morphAParam)].param;
+    const float* b = FACTORY_PRESETS[currentChoice(table->morphBIndex, morphBParam)].param;
+    float raw[NUM_PARAMS];
+    for (int i = 0; i < NUM_PARAMS; ++i) {
+        if (isSwitchParam(i)) {
+            raw[i] = (position < 0.5f) ? a[i] : b[i];
+        } else {
+            raw[i] = a[i] + position * (b[i] - a[i]);
+        }
     }
-    lfoInc = lfoRate * inverseUpdateRate * float(TWO_PI);
-    // For the glide:
-    glideMode = glideModeParam->getIndex();
-    float glideRateTemp = glideRateParam->get();
-    if (glideRateTemp < 2.0f) {
-        // No glide
-        glideRate = 1.0f;
-    } else {
-        glideRate = 1.0f - std::exp(-inverseUpdateRate * std::exp(6.0f - 0.07f * glideRateTemp));
+    RenderParams renderParams = RenderParams::derive(raw, sampleRate);
+    applyQualitySettings(renderParams);
+    return renderParams;
+}
+
+void Parameters::applyQualitySettings(RenderParams& renderParams) const {
+    renderParams.filterOversampling = 1 << currentChoice(table->filterOversamplingIndex, filterOversamplingParam);
+    renderParams.filterCoefficients = currentChoice(table->filterCoefficientsIndex, filterCoefficientsParam);
+    RenderParams::applySoundVersion(renderParams, soundVersion.load());
+}
+
+float Parameters::outputLevelToGain(float normalisedValue) const {
+    return juce::Decibels::decibelsToGain(outputLevelParam->convertFrom0to1(normalisedValue));
+}
+
+void Parameters::setCurrentProgram(int index) {
+    setPresetValues(FACTORY_PRESETS[index].param);
+}
+
+void Parameters::setPresetValues(const float* values) {
+    for (int i = 0; i < NUM_PARAMS; ++i) {
+        presetParams[i]->setValueNotifyingHost(presetParams[i]->convertTo0to1(values[i]));
     }
-    glideBend = glideBendParam->get();
-    numVoices = (polyModeParam->getIndex() == 0) ? 1 : MAX_VOICES;
-    // For the detune:
-    float semi = oscTuneParam->get();
-    float cent = oscFineParam->get();
-    // 1.05 = 2^(1/12), calculating the detune of the oscillator
-    // Use -semi because multiplication is cheaper than division
-    detune = std::pow(1.059463094359f, -semi - 0.01f * cent);
-    
-    // Overall tuning:
-    float octave = octaveParam->get();
-    float tuning = tuningParam->get();
-    float tuneInSemi = -36.3763f - 12.0f * octave - tuning / 100.0f;
-    tune = sampleRate * std::exp(0.05776226505f * tuneInSemi);
-//    tune = (octave * 12) + (tuning / 100.0f);
-    float filterVelocity = filterVelocityParam->get();
-    if (filterVelocity < -90.0f) {
-        velocitySensitivity = 0.0f;
-        ignoreVelocity = true;
-    } else {
-        velocitySensitivity = 0.0005f * filterVelocity;
-        ignoreVelocity = false;
+}
+
+void Parameters::getPresetValues(float* values) const {
+    for (int i = 0; i < NUM_PARAMS; ++i) {
+        values[i] = presetParams[i]->convertFrom0to1(currentValue(table->presetParamIndex[i]));
     }
-    // Update the envelope
-    float envOffset = 5.5f;
-    float envMult = 0.075f;
-    envAttack = std::exp(-inverseSampleRate * std::exp(envOffset - envMult * envAttackParam->get()));
-    envDecay = std::exp(-inverseSampleRate * std::exp(envOffset - envMult * envDecayParam->get()));
-    envSustain = envSustainParam->get() / 100.0f;
-    float envReleaseTemp = envReleaseParam->get();
-    if (envReleaseTemp < 1.0f) {
-        envRelease = 0.75f;
-    } else {
-        envRelease = std::exp(-inverseSampleRate * std::exp(envOffset - envMult * envRelease));
+}
+
+float Parameters::currentValue(int index) const {
+    float midiValue = midiValues[index].load();
+    return (midiValue >= 0.0f) ? midiValue : stateParams[index]->getValue();
+}
+
+int Parameters::currentChoice(int index, const juce::AudioParameterChoice* param) const {
+    return juce::jlimit(0, param->choices.size() - 1, juce::roundToInt(param->convertFrom0to1(currentValue(index))));
+}
+
+int Parameters::indexOfIDHash(uint32_t idHash) const {
+    for (int i = 0; i < NUM_STATE_PARAMS; ++i) {
+        if (table->idHashes[i] == idHash) {
+            return i;
+        }
     }
-    // Update the noise value we have
-    float noiseMixTemp = noiseParam->get() / 100.0f;
-    noiseMixTemp *= noiseMixTemp;
-    noiseMix = noiseMixTemp * 0.06f;
-    // Update the oscMix param
-    oscMix = oscMixParam->get() / 100.0f;
-    outputLevelSmoother.setTargetValue( juce::Decibels::decibelsToGain(outputLevelParam->get()));
-    // Filter Stuff:
-    filterKeyTracking = 0.08f * filterFreqParam->get() - 1.5f;
-    filterAttack = std::exp(-inverseUpdateRate * std::exp(envOffset - envMult * filterAttackParam->get()));
-    filterDecay = std::exp(-inverseUpdateRate * std::exp(envOffset - envMult * filterDecayParam->get()));
-    float filterSus = filterSustainParam->get() / 100.0f;
-    filterSustain = filterSus * filterSus;
-    filterRelease = std::exp(-inverseUpdateRate * std::exp(envOffset - envMult * filterReleaseParam->get()));
-    filterEnvDepth = 0.06f * filterEnvParam->get();
-    float filterReso = filterResoParam->get() / 100.0f;
-    float filterLFO = filterLFOParam->get() / 100.0f;
-    filterLFODepth = 2.5f * filterLFO * filterLFO;
-    filterQ = std::exp(3.0f * filterReso);
-    // Automatically adjust the volume (not sure what the magic numbers are for)
-    volumeTrim = 0.0008f * (3.2f - oscMix - 25.0f * noiseMix) * (1.5f - 0.5f  * filterReso);
-
-}
-
-void Parameters::reset(float sampleRate) {
-    // Assume the pitch wheel is in the center position when starting, and the mod wheel is all the way down
-    pitchBend = 1.0f;
-    modWheel = 0.0f;
-    outputLevelSmoother.reset(sampleRate, 0.05);
-    outputLevelSmoother.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(outputLevelParam->get()));
+    return -1;
 }
 
-void Parameters::setCurrentProgram(int index) {
-    juce::RangedAudioParameter *params[NUM_PARAMS] = {
-        oscMixParam,
-        oscTuneParam,
-        oscFineParam,
-        glideModeParam,
-        glideRateParam,
-        glideBendParam,
-        filterFreqParam,
-        filterResoParam,
-        filterEnvParam,
-        filterLFOParam,
-        filterVelocityParam,
-        filterAttackParam,
-        filterDecayParam,
-        filterSustainParam,
-        filterReleaseParam,
-        envAttackParam,
-        envDecayParam,
-        envSustainParam,
-        envReleaseParam,
-        lfoRateParam,
-        vibratoParam,
-        noiseParam,
-        octaveParam,
-        tuningParam,
-        outputLevelParam,
-        polyModeParam,
-    };
-    
-    const Preset& preset = presets[index];
-    
+int Parameters::indexOf(const juce::ParameterID& id) const {
+    return indexOfIDHash(PluginState::hashID(id.getParamID().toRawUTF8()));
+}
+
+void Parameters::setFromMidi(int index, float normalisedValue) {
+    midiValues[index].store(juce::jlimit(0.0f, 1.0f, normalisedValue));
+}
+
+void Parameters::notifyHostOfMidiValues() {
+    for (int i = 0; i < NUM_STATE_PARAMS; ++i) {
+        float value = midiValues[i].load();
+        if (value >= 0.0f) {
+            auto* param = stateParams[i];
+            param->beginChangeGesture();
+            param->setValueNotifyingHost(value);
+            param->endChangeGesture();
+            // Only clear it if another CC hasn't come in since
+            midiValues[i].compare_exchange_strong(value, -1.0f);
+        }
+    }
+}
+
+bool Parameters::matchesPreset(int index) const {
+    const Preset& preset = FACTORY_PRESETS[index];
     for (int i = 0; i < NUM_PARAMS; ++i) {
-        params[i]->setValueNotifyingHost(params[i]->convertTo0to1(preset.param[i]));
+        float value = presetParams[i]->convertTo0to1(preset.param[i]);
+        if (std::abs(presetParams[i]->getValue() - value) > 1e-4f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Parameters::writeState(PluginState::Writer& writer) const {
+    writer.beginChunk(PluginState::CHUNK_PARAMETERS);
+    writer.writeU32(uint32_t(NUM_STATE_PARAMS));
+    for (int i = 0; i < NUM_STATE_PARAMS; ++i) {
+        writer.writeU32(table->idHashes[i]);
+        writer.writeFloat(stateParams[i]->convertFrom0to1(stateParams[i]->getValue()));
+    }
+    writer.endChunk();
+}
+
+void Parameters::readState(PluginState::Reader& reader) {
+    // A parameter the state doesn't have (it's from an older version) goes back to its
+    // default, not to whatever the previous session or preset left it at
+    float normalised[NUM_STATE_PARAMS];
+    for (int i = 0; i < NUM_STATE_PARAMS; ++i) {
+        normalised[i] = stateParams[i]->getDefaultValue();
+    }
+    uint32_t count = reader.readU32();
+    for (uint32_t i = 0; i < count && !reader.hasFailed(); ++i) {
+        uint32_t idHash = reader.readU32();
+        float value = reader.readFloat();
+        // Parameters we don't know about (from a newer version) are skipped
+        int index = indexOfIDHash(idHash);
+        if (index >= 0 && !reader.hasFailed()) {
+            normalised[index] = stateParams[index]->convertTo0to1(value);
+        }
+    }
+    for (int i = 0; i < NUM_STATE_PARAMS; ++i) {
+        auto* param = stateParams[i];
+        if (normalised[i] != param->getValue()) {
+            param->setValueNotifyingHost(normalised[i]);
+        }
     }
 }
 
@@ -172,60 +205,83 @@ void Parameters::initParams(juce::AudioProcessorValueTreeState &apvts) {
     castParameter(apvts, ParameterID::tuning, tuningParam);
     castParameter(apvts, ParameterID::outputLevel, outputLevelParam);
     castParameter(apvts, ParameterID::polyMode, polyModeParam);
-}
-
-void Parameters::createDefaultPresets() {
-    presets.emplace_back("Init", 0.00f, -12.00f, 0.00f, 0.00f, 35.00f, 0.00f, 100.00f, 15.00f, 50.00f, 0.00f, 0.00f, 0.00f, 30.00f, 0.00f, 25.00f, 0.00f, 50.00f, 100.00f, 30.00f, 0.81f, 0.00f, 0.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("5th Sweep Pad", 100.00f, -7.00f, -6.30f, 1.00f, 32.00f, 0.00f, 90.00f, 60.00f, -76.00f, 0.00f, 0.00f, 90.00f, 89.00f, 90.00f, 73.00f, 0.00f, 50.00f, 100.00f, 71.00f, 0.81f, 30.00f, 0.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Echo Pad [SA]", 88.00f, 0.00f, 0.00f, 0.00f, 49.00f, 0.00f, 46.00f, 76.00f, 38.00f, 10.00f, 38.00f, 100.00f, 86.00f, 76.00f, 57.00f, 30.00f, 80.00f, 68.00f, 66.00f, 0.79f, -74.00f, 25.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Space Chimes [SA]", 88.00f, 0.00f, 0.00f, 0.00f, 49.00f, 0.00f, 49.00f, 82.00f, 32.00f, 8.00f, 78.00f, 85.00f, 69.00f, 76.00f, 47.00f, 12.00f, 22.00f, 55.00f, 66.00f, 0.89f, -32.00f, 0.00f, 2.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Solid Backing", 100.00f, -12.00f, -18.70f, 0.00f, 35.00f, 0.00f, 30.00f, 25.00f, 40.00f, 0.00f, 26.00f, 0.00f, 35.00f, 0.00f, 25.00f, 0.00f, 50.00f, 100.00f, 30.00f, 0.81f, 0.00f, 50.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Velocity Backing [SA]", 41.00f, 0.00f, 9.70f, 0.00f, 8.00f, -1.68f, 49.00f, 1.00f, -32.00f, 0.00f, 86.00f, 61.00f, 87.00f, 100.00f, 93.00f, 11.00f, 48.00f, 98.00f, 32.00f, 0.81f, 0.00f, 0.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Rubber Backing [ZF]", 29.00f, 12.00f, -5.60f, 0.00f, 18.00f, 5.06f, 35.00f, 15.00f, 54.00f, 14.00f, 8.00f, 0.00f, 42.00f, 13.00f, 21.00f, 0.00f, 56.00f, 0.00f, 32.00f, 0.20f, 16.00f, 22.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("808 State Lead", 100.00f, 7.00f, -7.10f, 2.00f, 34.00f, 12.35f, 65.00f, 63.00f, 50.00f, 16.00f, 0.00f, 0.00f, 30.00f, 0.00f, 25.00f, 17.00f, 50.00f, 100.00f, 3.00f, 0.81f, 0.00f, 0.00f, 1.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Mono Glide", 0.00f, -12.00f, 0.00f, 2.00f, 46.00f, 0.00f, 51.00f, 0.00f, 0.00f, 0.00f, -100.00f, 0.00f, 30.00f, 0.00f, 25.00f, 37.00f, 50.00f, 100.00f, 38.00f, 0.81f, 24.00f, 0.00f, 0.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Detuned Techno Lead", 84.00f, 0.00f, -17.20f, 2.00f, 41.00f, -0.15f, 54.00f, 1.00f, 16.00f, 21.00f, 34.00f, 0.00f, 9.00f, 100.00f, 25.00f, 20.00f, 85.00f, 100.00f, 30.00f, 0.83f, -82.00f, 40.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Hard Lead [SA]", 71.00f, 12.00f, 0.00f, 0.00f, 24.00f, 36.00f, 56.00f, 52.00f, 38.00f, 19.00f, 40.00f, 100.00f, 14.00f, 65.00f, 95.00f, 7.00f, 91.00f, 100.00f, 15.00f, 0.84f, -34.00f, 0.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Bubble", 0.00f, -12.00f, -0.20f, 0.00f, 71.00f, -0.00f, 23.00f, 77.00f, 60.00f, 32.00f, 26.00f, 40.00f, 18.00f, 66.00f, 14.00f, 0.00f, 38.00f, 65.00f, 16.00f, 0.48f, 0.00f, 0.00f, 1.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Monosynth", 62.00f, -12.00f, 0.00f, 1.00f, 35.00f, 0.02f, 64.00f, 39.00f, 2.00f, 65.00f, -100.00f, 7.00f, 52.00f, 24.00f, 84.00f, 13.00f, 30.00f, 76.00f, 21.00f, 0.58f, -40.00f, 0.00f, -1.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Moogcury Lite", 81.00f, 24.00f, -9.80f, 1.00f, 15.00f, -0.97f, 39.00f, 17.00f, 38.00f, 40.00f, 24.00f, 0.00f, 47.00f, 19.00f, 37.00f, 0.00f, 50.00f, 20.00f, 33.00f, 0.38f, 6.00f, 0.00f, -2.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Gangsta Whine", 0.00f, 0.00f, 0.00f, 2.00f, 44.00f, 0.00f, 41.00f, 46.00f, 0.00f, 0.00f, -100.00f, 0.00f, 0.00f, 100.00f, 25.00f, 15.00f, 50.00f, 100.00f, 32.00f, 0.81f, -2.00f, 0.00f, 2.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Higher Synth [ZF]", 48.00f, 0.00f, -8.80f, 0.00f, 0.00f, 0.00f, 50.00f, 47.00f, 46.00f, 30.00f, 60.00f, 0.00f, 10.00f, 0.00f, 7.00f, 0.00f, 42.00f, 0.00f, 22.00f, 0.21f, 18.00f, 16.00f, 2.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("303 Saw Bass", 0.00f, 0.00f, 0.00f, 1.00f, 49.00f, 0.00f, 55.00f, 75.00f, 38.00f, 35.00f, 0.00f, 0.00f, 56.00f, 0.00f, 56.00f, 0.00f, 80.00f, 100.00f, 24.00f, 0.26f, -2.00f, 0.00f, -2.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("303 Square Bass", 75.00f, 0.00f, 0.00f, 1.00f, 49.00f, 0.00f, 55.00f, 75.00f, 38.00f, 35.00f, 0.00f, 14.00f, 49.00f, 0.00f, 39.00f, 0.00f, 80.00f, 100.00f, 24.00f, 0.26f, -2.00f, 0.00f, -2.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Analog Bass", 100.00f, -12.00f, -10.90f, 1.00f, 19.00f, 0.00f, 30.00f, 51.00f, 70.00f, 9.00f, -100.00f, 0.00f, 88.00f, 0.00f, 21.00f, 0.00f, 50.00f, 100.00f, 46.00f, 0.81f, 0.00f, 0.00f, -1.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Analog Bass 2", 100.00f, -12.00f, -10.90f, 0.00f, 19.00f, 13.44f, 48.00f, 43.00f, 88.00f, 0.00f, 60.00f, 0.00f, 0.00f, 0.00f, 0.00f, 0.00f, 61.00f, 100.00f, 32.00f, 0.81f, 0.00f, 0.00f, -1.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Low Pulses", 97.00f, -12.00f, -3.30f, 0.00f, 35.00f, 0.00f, 80.00f, 40.00f, 4.00f, 0.00f, 0.00f, 0.00f, 77.00f, 0.00f, 25.00f, 0.00f, 50.00f, 100.00f, 30.00f, 0.81f, -68.00f, 0.00f, -2.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Sine Infra-Bass", 0.00f, -12.00f, 0.00f, 0.00f, 35.00f, 0.00f, 33.00f, 76.00f, 6.00f, 0.00f, 0.00f, 0.00f, 30.00f, 0.00f, 25.00f, 0.00f, 55.00f, 25.00f, 30.00f, 0.81f, 4.00f, 0.00f, -2.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Wobble Bass [SA]", 100.00f, -12.00f, -8.80f, 0.00f, 82.00f, 0.21f, 72.00f, 47.00f, -32.00f, 34.00f, 64.00f, 20.00f, 69.00f, 100.00f, 15.00f, 9.00f, 50.00f, 100.00f, 7.00f, 0.81f, -8.00f, 0.00f, -1.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Squelch Bass", 100.00f, -12.00f, -8.80f, 0.00f, 35.00f, 0.00f, 67.00f, 70.00f, -48.00f, 0.00f, 0.00f, 48.00f, 69.00f, 100.00f, 15.00f, 0.00f, 50.00f, 100.00f, 7.00f, 0.81f, -8.00f, 0.00f, -1.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Rubber Bass [ZF]", 49.00f, -12.00f, 1.60f, 1.00f, 35.00f, 0.00f, 36.00f, 15.00f, 50.00f, 20.00f, 0.00f, 0.00f, 38.00f, 0.00f, 25.00f, 0.00f, 60.00f, 100.00f, 22.00f, 0.19f, 0.00f, 0.00f, -2.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Soft Pick Bass", 37.00f, 0.00f, 7.80f, 0.00f, 22.00f, 0.00f, 33.00f, 47.00f, 42.00f, 16.00f, 18.00f, 0.00f, 0.00f, 0.00f, 25.00f, 4.00f, 58.00f, 0.00f, 22.00f, 0.15f, -12.00f, 33.00f, -2.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Fretless Bass", 50.00f, 0.00f, -14.40f, 1.00f, 34.00f, 0.00f, 51.00f, 0.00f, 16.00f, 0.00f, 34.00f, 0.00f, 9.00f, 0.00f, 25.00f, 20.00f, 85.00f, 0.00f, 30.00f, 0.81f, 40.00f, 0.00f, -2.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Whistler", 23.00f, 0.00f, -0.70f, 0.00f, 35.00f, 0.00f, 33.00f, 100.00f, 0.00f, 0.00f, 0.00f, 0.00f, 29.00f, 0.00f, 25.00f, 68.00f, 39.00f, 58.00f, 36.00f, 0.81f, 28.00f, 38.00f, 2.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Very Soft Pad", 39.00f, 0.00f, -4.90f, 2.00f, 12.00f, 0.00f, 35.00f, 78.00f, 0.00f, 0.00f, 0.00f, 0.00f, 30.00f, 0.00f, 25.00f, 35.00f, 50.00f, 80.00f, 70.00f, 0.81f, 0.00f, 0.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Pizzicato", 0.00f, -12.00f, 0.00f, 0.00f, 35.00f, 0.00f, 23.00f, 20.00f, 50.00f, 0.00f, 0.00f, 0.00f, 22.00f, 0.00f, 25.00f, 0.00f, 47.00f, 0.00f, 30.00f, 0.81f, 0.00f, 80.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Synth Strings", 100.00f, 0.00f, -7.10f, 0.00f, 0.00f, -0.97f, 42.00f, 26.00f, 50.00f, 14.00f, 38.00f, 0.00f, 67.00f, 55.00f, 97.00f, 82.00f, 70.00f, 100.00f, 42.00f, 0.84f, 34.00f, 30.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Synth Strings 2", 75.00f, 0.00f, -3.80f, 0.00f, 49.00f, 0.00f, 55.00f, 16.00f, 38.00f, 8.00f, -60.00f, 76.00f, 29.00f, 76.00f, 100.00f, 46.00f, 80.00f, 100.00f, 39.00f, 0.79f, -46.00f, 0.00f, 1.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Leslie Organ", 0.00f, 0.00f, 0.00f, 0.00f, 13.00f, -0.38f, 38.00f, 74.00f, 8.00f, 20.00f, -100.00f, 0.00f, 55.00f, 52.00f, 31.00f, 0.00f, 17.00f, 73.00f, 28.00f, 0.87f, -52.00f, 0.00f, -1.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Click Organ", 50.00f, 12.00f, 0.00f, 0.00f, 35.00f, 0.00f, 44.00f, 50.00f, 30.00f, 16.00f, -100.00f, 0.00f, 0.00f, 18.00f, 0.00f, 0.00f, 75.00f, 80.00f, 0.00f, 0.81f, -2.00f, 0.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Hard Organ", 89.00f, 19.00f, -0.90f, 0.00f, 35.00f, 0.00f, 51.00f, 62.00f, 8.00f, 0.00f, -100.00f, 0.00f, 37.00f, 0.00f, 100.00f, 4.00f, 8.00f, 72.00f, 4.00f, 0.77f, -2.00f, 0.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Bass Clarinet", 100.00f, 0.00f, 0.00f, 1.00f, 0.00f, 0.00f, 51.00f, 10.00f, 0.00f, 11.00f, 0.00f, 0.00f, 0.00f, 0.00f, 25.00f, 35.00f, 65.00f, 65.00f, 32.00f, 0.79f, -2.00f, 20.00f, -1.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Trumpet", 0.00f, 0.00f, 0.00f, 1.00f, 6.00f, 0.00f, 57.00f, 0.00f, -36.00f, 15.00f, 0.00f, 21.00f, 15.00f, 0.00f, 25.00f, 24.00f, 60.00f, 80.00f, 10.00f, 0.75f, 10.00f, 25.00f, 1.00f, 0.00f, 0.00f, 0.00f);
-    presets.emplace_back("Soft Horn", 12.00f, 19.00f, 1.90f, 0.00f, 35.00f, 0.00f, 50.00f, 21.00f, -42.00f, 12.00f, 20.00f, 0.00f, 35.00f, 36.00f, 25.00f, 8.00f, 50.00f, 100.00f, 27.00f, 0.83f, 2.00f, 10.00f, -1.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Brass Section", 43.00f, 12.00f, -7.90f, 0.00f, 28.00f, -0.79f, 50.00f, 0.00f, 18.00f, 0.00f, 0.00f, 24.00f, 16.00f, 91.00f, 8.00f, 17.00f, 50.00f, 80.00f, 45.00f, 0.81f, 0.00f, 0.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Synth Brass", 40.00f, 0.00f, -6.30f, 0.00f, 30.00f, -3.07f, 39.00f, 15.00f, 50.00f, 0.00f, 0.00f, 39.00f, 30.00f, 82.00f, 25.00f, 33.00f, 74.00f, 76.00f, 41.00f, 0.81f, -6.00f, 23.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Detuned Syn Brass [ZF]", 68.00f, 0.00f, 31.80f, 0.00f, 31.00f, 0.50f, 26.00f, 7.00f, 70.00f, 0.00f, 32.00f, 0.00f, 83.00f, 0.00f, 5.00f, 0.00f, 75.00f, 54.00f, 32.00f, 0.76f, -26.00f, 29.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Power PWM", 100.00f, -12.00f, -8.80f, 0.00f, 35.00f, 0.00f, 82.00f, 13.00f, 50.00f, 0.00f, -100.00f, 24.00f, 30.00f, 88.00f, 34.00f, 0.00f, 50.00f, 100.00f, 48.00f, 0.71f, -26.00f, 0.00f, -1.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Water Velocity [SA]", 76.00f, 0.00f, -1.40f, 0.00f, 49.00f, 0.00f, 87.00f, 67.00f, 100.00f, 32.00f, -82.00f, 95.00f, 56.00f, 72.00f, 100.00f, 4.00f, 76.00f, 11.00f, 46.00f, 0.88f, 44.00f, 0.00f, -1.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Ghost [SA]", 75.00f, 0.00f, -7.10f, 2.00f, 16.00f, -0.00f, 38.00f, 58.00f, 50.00f, 16.00f, 62.00f, 0.00f, 30.00f, 40.00f, 31.00f, 37.00f, 50.00f, 100.00f, 54.00f, 0.85f, 66.00f, 43.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Soft E.Piano", 31.00f, 0.00f, -0.20f, 0.00f, 35.00f, 0.00f, 34.00f, 26.00f, 6.00f, 0.00f, 26.00f, 0.00f, 22.00f, 0.00f, 39.00f, 0.00f, 80.00f, 0.00f, 44.00f, 0.81f, 2.00f, 0.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Thumb Piano", 72.00f, 15.00f, 50.00f, 0.00f, 35.00f, 0.00f, 37.00f, 47.00f, 8.00f, 0.00f, 0.00f, 0.00f, 45.00f, 0.00f, 39.00f, 0.00f, 39.00f, 0.00f, 48.00f, 0.81f, 20.00f, 0.00f, 1.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Steel Drums [ZF]", 81.00f, 12.00f, -12.00f, 0.00f, 18.00f, 2.30f, 40.00f, 30.00f, 8.00f, 17.00f, -20.00f, 0.00f, 42.00f, 23.00f, 47.00f, 12.00f, 48.00f, 0.00f, 49.00f, 0.53f, -28.00f, 34.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Car Horn", 57.00f, -1.00f, -2.80f, 0.00f, 35.00f, 0.00f, 46.00f, 0.00f, 36.00f, 0.00f, 0.00f, 46.00f, 30.00f, 100.00f, 23.00f, 30.00f, 50.00f, 100.00f, 31.00f, 1.00f, -24.00f, 0.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Helicopter", 0.00f, -12.00f, 0.00f, 0.00f, 35.00f, 0.00f, 8.00f, 36.00f, 38.00f, 100.00f, 0.00f, 100.00f, 100.00f, 0.00f, 100.00f, 96.00f, 50.00f, 100.00f, 92.00f, 0.97f, 0.00f, 100.00f, -2.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Arctic Wind", 0.00f, -12.00f, 0.00f, 0.00f, 35.00f, 0.00f, 16.00f, 85.00f, 0.00f, 28.00f, 0.00f, 37.00f, 30.00f, 0.00f, 25.00f, 89.00f, 50.00f, 100.00f, 89.00f, 0.24f, 0.00f, 100.00f, 2.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Thip", 100.00f, -7.00f, 0.00f, 0.00f, 35.00f, 0.00f, 0.00f, 100.00f, 94.00f, 0.00f, 0.00f, 2.00f, 20.00f, 0.00f, 20.00f, 0.00f, 46.00f, 0.00f, 30.00f, 0.81f, 0.00f, 78.00f, 0.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Synth Tom", 0.00f, -12.00f, 0.00f, 0.00f, 76.00f, 24.53f, 30.00f, 33.00f, 52.00f, 0.00f, 36.00f, 0.00f, 59.00f, 0.00f, 59.00f, 10.00f, 50.00f, 0.00f, 50.00f, 0.81f, 0.00f, 70.00f, -2.00f, 0.00f, 0.00f, 1.00f);
-    presets.emplace_back("Squelchy Frog", 50.00f, -5.00f, -7.90f, 2.00f, 77.00f, -36.00f, 40.00f, 65.00f, 90.00f, 0.00f, 0.00f, 33.00f, 50.00f, 0.00f, 25.00f, 0.00f, 70.00f, 65.00f, 18.00f, 0.32f, 100.00f, 0.00f, -2.00f, 0.00f, 0.00f, 1.00f);
+    castParameter(apvts, ParameterID::oscEngine, oscEngineParam);
+    castParameter(apvts, ParameterID::filterType, filterTypeParam);
+    castParameter(apvts, ParameterID::noiseType, noiseTypeParam);
+    castParameter(apvts, ParameterID::noiseSpread, noiseSpreadParam);
+    castParameter(apvts, ParameterID::lfoWave, lfoWaveParam);
+    castParameter(apvts, ParameterID::filterOversampling, filterOversamplingParam);
+    castParameter(apvts, ParameterID::filterCoefficients, filterCoefficientsParam);
+    castParameter(apvts, ParameterID::morph, morphParam);
+    castParameter(apvts, ParameterID::morphA, morphAParam);
+    castParameter(apvts, ParameterID::morphB, morphBParam);
+    castParameter(apvts, ParameterID::morphPosition, morphPositionParam);
+    
+    juce::RangedAudioParameter* params[NUM_PARAMS] = {
+        oscMixParam,
+        oscTuneParam,
+        oscFineParam,
+        glideModeParam,
+        glideRateParam,
+        glideBendParam,
+        filterFreqParam,
+        filterResoParam,
+        filterEnvParam,
+        filterLFOParam,
+        filterVelocityParam,
+        filterAttackParam,
+        filterDecayParam,
+        filterSustainParam,
+        filterReleaseParam,
+        envAttackParam,
+        envDecayParam,
+        envSustainParam,
+        envReleaseParam,
+        lfoRateParam,
+        vibratoParam,
+        noiseParam,
+        octaveParam,
+        tuningParam,
+        outputLevelParam,
+        polyModeParam,
+        oscEngineParam,
+        filterTypeParam,
+        noiseTypeParam,
+        noiseSpreadParam,
+        lfoWaveParam,
+    };
+    std::copy(params, params + NUM_PARAMS, presetParams);
+    
+    // Every parameter comes from the APVTS, so they're all ranged.  Only checked in debug
+    // builds, like castParameter
+    const auto& parameters = apvts.processor.getParameters();
+    jassert(parameters.size() == NUM_STATE_PARAMS);
+    for (int i = 0; i < NUM_STATE_PARAMS; ++i) {
+        jassert(dynamic_cast<juce::RangedAudioParameter*>(parameters[i]) != nullptr);
+        stateParams[i] = static_cast<juce::RangedAudioParameter*>(parameters[i]);
+        midiValues[i].store(-1.0f);
+    }
+    // The layout is the same in every instance, so the first one works out the table
+    table = SharedResources<ParameterTable>::get(0.0, [this](ParameterTable& newTable) {
+        for (int i = 0; i < NUM_STATE_PARAMS; ++i) {
+            newTable.idHashes[i] = PluginState::hashID(stateParams[i]->getParameterID().toRawUTF8());
+            // Two IDs with the same hash would load into the wrong parameter
+            jassert(std::find(newTable.idHashes, newTable.idHashes + i, newTable.idHashes[i]) == newTable.idHashes + i);
+        }
+        auto indexOfID = [&newTable](const juce::String& paramID) {
+            const uint32_t idHash = PluginState::hashID(paramID.toRawUTF8());
+            const auto* found = std::find(newTable.idHashes, newTable.idHashes + NUM_STATE_PARAMS, idHash);
+            jassert(found != newTable.idHashes + NUM_STATE_PARAMS);
+            return int(found - newTable.idHashes);
+        };
+        for (int i = 0; i < NUM_PARAMS; ++i) {
+            newTable.presetParamIndex[i] = indexOfID(presetParams[i]->getParameterID());
+        }
+        newTable.morphIndex = indexOfID(ParameterID::morph.getParamID());
+        newTable.morphAIndex = indexOfID(ParameterID::morphA.getParamID());
+        newTable.morphBIndex = indexOfID(ParameterID::morphB.getParamID());
+        newTable.morphPositionIndex = indexOfID(ParameterID::morphPosition.getParamID());
+        newTable.filterOversamplingIndex = indexOfID(ParameterID::filterOversampling.getParamID());
+        newTable.filterCoefficientsIndex = indexOfID(ParameterID::filterCoefficients.getParamID());
+    });
 }
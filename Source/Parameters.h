@@ -12,12 +12,18 @@
 
 #include <JuceHeader.h>
 #include "Preset.h"
+#include "RenderParams.h"
+#include "FactoryPresets.h"
+#include "PluginState.h"
+#include "SharedResources.h"
 
 template<typename T>
 inline static void castParameter(juce::AudioProcessorValueTreeState& apvts, const juce::ParameterID& id, T& destination) {
-    destination = dynamic_cast<T>(apvts.getParameter(id.getParamID()));
-    // Parameter does not exist or is wrong type
-    jassert(destination);
+    auto* parameter = apvts.getParameter(id.getParamID());
+    // Parameter does not exist or is wrong type.  Only checked in debug builds, the
+    // layout is fixed so a static_cast is enough
+    jassert(dynamic_cast<T>(parameter) != nullptr);
+    destination = static_cast<T>(parameter);
 }
 
 namespace ParameterID {
@@ -50,51 +56,112 @@ namespace ParameterID {
     PARAMETER_ID(tuning)
     PARAMETER_ID(outputLevel)
     PARAMETER_ID(polyMode)
+    PARAMETER_ID(oscEngine)
+    PARAMETER_ID(filterType)
+    PARAMETER_ID(noiseType)
+    PARAMETER_ID(noiseSpread)
+    PARAMETER_ID(lfoWave)
+    PARAMETER_ID(filterOversampling)
+    PARAMETER_ID(filterCoefficients)
+    PARAMETER_ID(morph)
+    PARAMETER_ID(morphA)
+    PARAMETER_ID(morphB)
+    PARAMETER_ID(morphPosition)
 
     #undef PARAMETER_ID
 }
 
-static constexpr int MAX_VOICES = 8;
-
 class Parameters {
     public:
         void initParams(juce::AudioProcessorValueTreeState& apvts);
-        void updateParams(float sampleRate);
+        // Reads the current parameter values and works out everything the synth needs.
+        // Only reads atomics, so the audio thread can call it once per block
+        RenderParams makeRenderParams(float sampleRate) const;
+        // Works out a RenderParams for every preset, so a Program Change on the audio thread
+        // only has to copy one.  Call it when the sample rate changes (not while rendering)
+        void buildPresetSnapshots(float sampleRate);
+        // The snapshot for a preset, with the current quality settings
+        RenderParams presetSnapshot(int index) const;
+        // Which version of the sound the snapshots are made for (see RenderParams::SOUND_VERSION).
+        // Part of the session, the audio thread picks it up with the next snapshot
+        void setSoundVersion(int version) { soundVersion.store(version); }
+        int getSoundVersion() const { return soundVersion.load(); }
+        // With Morph on, the synth plays a mix of factory presets A and B instead of the
+        // knobs.  The knobs aren't touched, so the host doesn't hear about any of it
+        bool isMorphing() const;
+        // 0 is all A, 1 is all B
+        float getMorphPosition() const;
+        // The raw values are interpolated and then derived, like makeRenderParams.  Only
+        // reads atomics, so the audio thread can call it as often as the morph moves
+        RenderParams makeMorphParams(float position, float sampleRate) const;
         void setCurrentProgram(int index);
-        void createDefaultPresets();
-        void reset(float sampleRate);
+        // Sets the preset parameters from values in Preset order (a factory or user preset)
+        void setPresetValues(const float* values);
+        // The current values in Preset order, for saving a user preset
+        void getPresetValues(float* values) const;
+        // True if the parameters already hold the preset's values (for skipping setCurrentProgram)
+        bool matchesPreset(int index) const;
+        // Message thread only, the host doesn't expect to hear about changes from the audio thread
         void changeOutputLevelNotifyHost(float newVal);
-        float oscMix;
-        float detune;
-        float tune;
-        float velocitySensitivity;
-        bool ignoreVelocity;
-        float lfoInc;
-        float vibratoAmount;
-        float pwmDepth;
-        float envAttack, envDecay, envSustain, envRelease;
-        float volumeTrim;   // Used to automatically adjust the volume
-        juce::LinearSmoothedValue<float> outputLevelSmoother;
-        float noiseMix;
-        // Filter Stuff:
-        float filterKeyTracking;
-        float filterQ;
-        float filterLFODepth;
-        float filterAttack, filterDecay, filterSustain, filterRelease;
-        float filterEnvDepth;
-        // Overall Stuff:
-        float pitchBend;
-        float modWheel;
-        int glideMode;
-        float glideRate;
-        float glideBend;
-        int numVoices;
-        static constexpr float ANALOG = 0.002f;
-        std::vector<Preset> presets;
-        int totalPresets() {
-            return int(presets.size());
+        // The gain for a normalised (0 to 1) Output Level value
+        float outputLevelToGain(float normalisedValue) const;
+        // Every APVTS parameter: the preset ones, the quality settings and the morph
+        static constexpr int NUM_STATE_PARAMS = NUM_PARAMS + 6;
+        // Parameters by index in AudioProcessor::getParameters(), for the MIDI CC map.
+        // The ID hash is what gets saved, the index can change between versions
+        int numParameters() const { return NUM_STATE_PARAMS; }
+        int indexOfIDHash(uint32_t idHash) const;
+        uint32_t idHashOf(int index) const { return table->idHashes[index]; }
+        int indexOf(const juce::ParameterID& id) const;
+        // Audio thread.  The value (normalised) is used from the next makeRenderParams on,
+        // and notifyHostOfMidiValues passes it on to the parameter
+        void setFromMidi(int index, float normalisedValue);
+        // Message thread, from a timer
+        void notifyHostOfMidiValues();
+        // The parameters chunk of the plugin state, every APVTS parameter by ID hash
+        void writeState(PluginState::Writer& writer) const;
+        // Reads that chunk back.  Parameters missing from it are set to their defaults.
+        // Only the parameters that are different get set, so the host and the listeners
+        // only hear about real changes
+        void readState(PluginState::Reader& reader);
+        static constexpr int totalPresets() {
+            return NUM_FACTORY_PRESETS;
+        }
+        static const Preset& preset(int index) {
+            return FACTORY_PRESETS[index];
         }
     private:
+        // The preset parameters in Preset order
+        juce::RangedAudioParameter* presetParams[NUM_PARAMS];
+        using PresetSnapshots = std::array<RenderParams, NUM_FACTORY_PRESETS>;
+        // Shared by every instance running at the same sample rate
+        std::shared_ptr<const PresetSnapshots> presetSnapshots;
+        // What follows from the layout, which is the same in every instance
+        struct ParameterTable {
+            uint32_t idHashes[NUM_STATE_PARAMS];
+            // Where each preset parameter is in stateParams
+            int presetParamIndex[NUM_PARAMS];
+            // Where the parameters read outside the presets are
+            int morphIndex;
+            int morphAIndex;
+            int morphBIndex;
+            int morphPositionIndex;
+            int filterOversamplingIndex;
+            int filterCoefficientsIndex;
+        };
+        // Built by the first instance, shared by the rest
+        std::shared_ptr<const ParameterTable> table;
+        // In AudioProcessor::getParameters() order
+        juce::RangedAudioParameter* stateParams[NUM_STATE_PARAMS];
+        // The values from MIDI the host hasn't heard about yet, by parameter index (-1 is none)
+        std::atomic<float> midiValues[NUM_STATE_PARAMS];
+        std::atomic<int> soundVersion { RenderParams::SOUND_VERSION };
+        // The MIDI value if there is one, otherwise the parameter's (normalised)
+        float currentValue(int index) const;
+        // The same for a choice parameter, as the choice index
+        int currentChoice(int index, const juce::AudioParameterChoice* param) const;
+        // Fills in the settings that aren't part of the presets (and the sound version)
+        void applyQualitySettings(RenderParams& renderParams) const;
         // All the parameter objects (pointers)
         juce::AudioParameterFloat* oscMixParam;
         juce::AudioParameterFloat* oscTuneParam;
@@ -122,4 +189,15 @@ class Parameters {
         juce::AudioParameterFloat* tuningParam;
         juce::AudioParameterFloat* outputLevelParam;
         juce::AudioParameterChoice* polyModeParam;
+        juce::AudioParameterChoice* oscEngineParam;
+        juce::AudioParameterChoice* filterTypeParam;
+        juce::AudioParameterChoice* noiseTypeParam;
+        juce::AudioParameterChoice* noiseSpreadParam;
+        juce::AudioParameterChoice* lfoWaveParam;
+        juce::AudioParameterChoice* filterOversamplingParam;
+        juce::AudioParameterChoice* filterCoefficientsParam;
+        juce::AudioParameterChoice* morphParam;
+        juce::AudioParameterChoice* morphAParam;
+        juce::AudioParameterChoice* morphBParam;
+        juce::AudioParameterFloat* morphPositionParam;
 };
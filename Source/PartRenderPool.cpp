@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    PartRenderPool.cpp
+    Created: 20 Oct 2026 3:25:52am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include "PartRenderPool.h"
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+#elif JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#else
+ #include <cerrno>
+ #include <semaphore.h>
+#endif
+
+namespace {
+    // Roughly a few microseconds of checking before a worker goes to sleep.  With
+    // small buffers the next block is often there by then
+    constexpr int SPIN_COUNT = 10000;
+
+    uint32_t generationOf(uint64_t state) {
+        return uint32_t(state >> 32);
+    }
+}
+
+class PartRenderPool::Semaphore {
+    public:
+       #if JUCE_WINDOWS
+        Semaphore() : handle(CreateSemaphore(nullptr, 0, LONG_MAX, nullptr)) {}
+        ~Semaphore() { CloseHandle(handle); }
+        void post() { ReleaseSemaphore(handle, 1, nullptr); }
+        void wait() { WaitForSingleObject(handle, INFINITE); }
+       #elif JUCE_MAC || JUCE_IOS
+        Semaphore() : handle(dispatch_semaphore_create(0)) {}
+        ~Semaphore() { dispatch_release(handle); }
+        void post() { dispatch_semaphore_signal(handle); }
+        void wait() { dispatch_semaphore_wait(handle, DISPATCH_TIME_FOREVER); }
+       #else
+        Semaphore() { sem_init(&handle, 0, 0); }
+        ~Semaphore() { sem_destroy(&handle); }
+        void post() { sem_post(&handle); }
+        void wait() {
+            while (sem_wait(&handle) != 0 && errno == EINTR) {
+            }
+        }
+       #endif
+
+    private:
+       #if JUCE_WINDOWS
+        HANDLE handle;
+       #elif JUCE_MAC || JUCE_IOS
+        dispatch_semaphore_t handle;
+       #else
+        sem_t handle;
+       #endif
+};
+
+PartRenderPool::~PartRenderPool() {
+    stop();
+}
+
+void PartRenderPool::start(int numThreads, double blockMs) {
+    stop();
+    // The audio thread waits for these, so they need to be scheduled like it is
+    const auto options = juce::Thread::RealtimeOptions().withPriority(10).withPeriodMs(blockMs);
+    for (int i = 0; i < numThreads; ++i) {
+        workers.push_back(std::make_unique<Worker>(*this));
+        if (!workers.back()->startRealtimeThread(options)) {
+            // Not allowed to (Linux without an rtprio limit), the next best thing
+            workers.back()->startThread(juce::Thread::Priority::highest);
+        }
+    }
+}
+
+void PartRenderPool::stop() {
+    for (auto& worker : workers) {
+        worker->signalThreadShouldExit();
+        worker->wake();
+    }
+    for (auto& worker : workers) {
+        worker->stopThread(1000);
+    }
+    workers.clear();
+}
+
+void PartRenderPool::run(Job job, void* context, int numJobs) {
+    jassert(numJobs < 0x10000);
+    // Every job from the previous run has finished, so nobody is reading these
+    currentJob = job;
+    currentContext = context;
+    finishedJobs.store(0);
+    const uint64_t generation = generationOf(state.load()) + 1;
+    state.store((generation << 32) | (uint64_t(numJobs) << 16));
+    for (auto& worker : workers) {
+        worker->wake();
+    }
+    // Everything a worker hasn't got to yet is done here
+    while (doNextJob()) {
+    }
+    // Only the jobs the workers are in the middle of are left.  That's less than a
+    // part's worth of work, so spin rather than give up the time slice
+    while (finishedJobs.load() < numJobs) {
+    }
+}
+
+bool PartRenderPool::doNextJob() {
+    uint64_t current = state.load();
+    for (;;) {
+        const int numJobs = int((current >> 16) & 0xFFFF);
+        const int next = int(current & 0xFFFF);
+        if (next >= numJobs) {
+            return false;
+        }
+        if (state.compare_exchange_weak(current, current + 1)) {
+            currentJob(currentContext, next);
+            finishedJobs.fetch_add(1);
+            return true;
+        }
+    }
+}
+
+PartRenderPool::Worker::Worker(PartRenderPool& pool_)
+    : juce::Thread("JX11 part renderer"), pool(pool_), semaphore(std::make_unique<Semaphore>()) {}
+
+PartRenderPool::Worker::~Worker() = default;
+
+void PartRenderPool::Worker::wake() {
+    if (asleep.exchange(false)) {
+        semaphore->post();
+    }
+}
+
+void PartRenderPool::Worker::run() {
+    uint32_t seen = generationOf(pool.state.load());
+    while (!threadShouldExit()) {
+        for (int i = 0; i < SPIN_COUNT && generationOf(pool.state.load()) == seen; ++i) {
+        }
+        // asleep goes up before the generation and the exit flag are checked, and
+        // wake() clears it after they're set, so one of the two sides always sees
+        // the other.  If wake() got in first its post has to be taken
+        asleep.store(true);
+        if (generationOf(pool.state.load()) == seen && !threadShouldExit()) {
+            semaphore->wait();
+        } else if (!asleep.exchange(false)) {
+            semaphore->wait();
+        }
+        seen = generationOf(pool.state.load());
+        while (pool.doNextJob()) {
+        }
+    }
+}
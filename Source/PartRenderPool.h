@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    PartRenderPool.h
+    Created: 20 Oct 2026 3:25:52am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Runs one block's worth of jobs (the multi-timbral parts) on a few worker threads
+// and the audio thread together.  The jobs are handed out through one atomic, and
+// the audio thread takes every job nobody has started yet and then waits for the
+// ones still running, so the block takes about as long as the slowest part instead
+// of all of them added up.
+//
+// run() doesn't allocate or take a lock.  A new run is a new generation in `state`:
+// a worker that has just finished spins on it for a little while, and only one that
+// has gone to sleep gets its semaphore posted, which is a single system call.
+class PartRenderPool {
+    public:
+        using Job = void (*)(void* context, int index);
+
+        ~PartRenderPool();
+
+        // Message thread, while the audio isn't running.  0 threads runs everything on
+        // the audio thread.  The workers are realtime threads with the audio callback's
+        // period, blockMs
+        void start(int numThreads, double blockMs);
+        void stop();
+        int getNumThreads() const noexcept { return int(workers.size()); }
+
+        // Audio thread.  Calls job(context, i) once for every i from 0 to numJobs - 1
+        // and returns when they've all finished
+        void run(Job job, void* context, int numJobs);
+
+    private:
+        // A counting semaphore from the OS, posting it doesn't take a lock
+        class Semaphore;
+
+        class Worker : public juce::Thread {
+            public:
+                explicit Worker(PartRenderPool& pool_);
+                ~Worker() override;
+                void run() override;
+                // Wakes the worker if it's asleep
+                void wake();
+            private:
+                PartRenderPool& pool;
+                std::unique_ptr<Semaphore> semaphore;
+                std::atomic<bool> asleep { false };
+        };
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        // The generation (top 32 bits), the number of jobs (16 bits) and the next job to
+        // hand out (16 bits) in one word, so a worker that wakes up late can never take
+        // a job from one run with the count from another
+        std::atomic<uint64_t> state { 0 };
+        std::atomic<int> finishedJobs { 0 };
+        Job currentJob = nullptr;
+        void* currentContext = nullptr;
+
+        // Takes the next job and does it, returns false when there are none left
+        bool doNextJob();
+};
@@ -16,24 +16,78 @@ JX11AudioProcessorEditor::JX11AudioProcessorEditor (JX11AudioProcessor& p)
     juce::LookAndFeel::setDefaultLookAndFeel(&globalLNF);
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be
-    outputLevelKnob.label = "Level";
-    addAndMakeVisible(outputLevelKnob);
-    filterResoKnob.label = "Reso";
-    addAndMakeVisible(filterResoKnob);
+    addKnob(ParameterID::oscMix, "Osc Mix", 0);
+    addKnob(ParameterID::oscTune, "Tune", 0);
+    addKnob(ParameterID::oscFine, "Fine", 0);
+    addKnob(ParameterID::octave, "Octave", 0);
+    addKnob(ParameterID::tuning, "Tuning", 0);
+    addKnob(ParameterID::noise, "Noise", 0);
+    addChoice(ParameterID::oscEngine, "Osc Engine", 0);
+    addChoice(ParameterID::noiseType, "Noise Type", 0);
+    addChoice(ParameterID::noiseSpread, "Noise Spread", 0);
+
+    addKnob(ParameterID::filterFreq, "Cutoff", 1);
+    addKnob(ParameterID::filterReso, "Reso", 1);
+    addKnob(ParameterID::filterEnv, "Env", 1);
+    addKnob(ParameterID::filterLFO, "LFO", 1);
+    addKnob(ParameterID::filterVelocity, "Velocity", 1);
+    addKnob(ParameterID::filterAttack, "Attack", 1);
+    addKnob(ParameterID::filterDecay, "Decay", 1);
+    addKnob(ParameterID::filterSustain, "Sustain", 1);
+    addKnob(ParameterID::filterRelease, "Release", 1);
+    addChoice(ParameterID::filterType, "Filter Type", 1);
+
+    addKnob(ParameterID::envAttack, "Attack", 2);
+    addKnob(ParameterID::envDecay, "Decay", 2);
+    addKnob(ParameterID::envSustain, "Sustain", 2);
+    addKnob(ParameterID::envRelease, "Release", 2);
+    addKnob(ParameterID::lfoRate, "LFO Rate", 2);
+    addKnob(ParameterID::vibrato, "Vibrato", 2);
+    addKnob(ParameterID::glideRate, "Glide", 2);
+    addKnob(ParameterID::glideBend, "Bend", 2);
+    addKnob(ParameterID::outputLevel, "Level", 2);
+    addChoice(ParameterID::lfoWave, "LFO Wave", 2);
+    addChoice(ParameterID::glideMode, "Glide Mode", 2);
+
+    addKnob(ParameterID::morphPosition, "Morph", 3);
+    addChoice(ParameterID::morphA, "Morph A", 3);
+    addChoice(ParameterID::morphB, "Morph B", 3);
+    addChoice(ParameterID::filterOversampling, "Oversampling", 3);
+    addChoice(ParameterID::filterCoefficients, "Coefficients", 3);
     
     polyModeButton.setButtonText("Poly");
-    polyModeButton.setClickingTogglesState(true);
     addAndMakeVisible(polyModeButton);
+    attachments.attach(polyModeButton, ParameterID::polyMode);
+    morphButton.setButtonText("Morph");
+    addAndMakeVisible(morphButton);
+    attachments.attach(morphButton, ParameterID::morph);
     // MIDI Learn Button:
     midiLearnButton.setButtonText("MIDI Learn");
     midiLearnButton.addListener(this);
     addAndMakeVisible(midiLearnButton);
+    addOption(multiTimbralButton, "Multi", [this](bool on) {
+        audioProcessor.setMultiTimbral(on);
+        audioProcessor.prepareAgain();
+    });
+    addOption(fixedRenderRateButton, "Fixed Rate", [this](bool on) {
+        audioProcessor.setFixedRenderRate(on);
+        audioProcessor.prepareAgain();
+    });
+    addOption(releaseOnProgramChangeButton, "PC Release", [this](bool on) {
+        audioProcessor.setReleaseOnProgramChange(on);
+    });
+    updateOptions();
+    addAndMakeVisible(presetBrowser);
+    addAndMakeVisible(analyser);
     // Should be done at the end
-    setSize (600, 400);
+    setSize (960, 860);
+    audioProcessor.getTelemetry().setActive(true);
+    startTimerHz(30);
 }
 
 JX11AudioProcessorEditor::~JX11AudioProcessorEditor()
 {
+    audioProcessor.getTelemetry().setActive(false);
     midiLearnButton.removeListener(this);
     audioProcessor.midiLearn = false;
 }
@@ -43,6 +97,16 @@ void JX11AudioProcessorEditor::paint (juce::Graphics& g)
 {
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+    g.setColour(juce::Colour(180, 180, 180));
+    g.setFont(13.0f);
+    g.drawText(statusText, statusArea, juce::Justification::centredLeft);
+    // The row titles
+    static const char* const rowTitles[NUM_ROWS] = { "OSC", "FILTER", "AMP / MOD", "MORPH" };
+    g.setColour(juce::Colours::white);
+    g.setFont(14.0f);
+    for (int row = 0; row < NUM_ROWS; ++row) {
+        g.drawText(rowTitles[row], 10, 10 + row * 115, 70, 110, juce::Justification::centredLeft);
+    }
 //    g.setColour (juce::Colours::white);
 //    g.setFont (juce::FontOptions (15.0f));
 //    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
@@ -52,33 +116,119 @@ void JX11AudioProcessorEditor::resized()
 {
     // This is generally where you'll want to lay out the positions of any
     // subcomponents in your editor.
-    int knobwidth = 100;
-    int padding = 20;
-    juce::Rectangle r(padding, padding, knobwidth, knobwidth + 20);
-    outputLevelKnob.setBounds(r);
-    
-    r = r.withX(r.getRight() + padding);
-    filterResoKnob.setBounds(r);
-    
-    int textButtonWidth = 80;
-    int textButtonHeight = 30;
-    polyModeButton.setSize(textButtonWidth, textButtonHeight);
-    polyModeButton.setCentrePosition(r.withX(r.getRight()).getCentre());
-    // For the MIDI learn button:
-    midiLearnButton.setBounds(400, 20, 100, 30);
+    // Each row is its knobs, then its choices two to a column
+    const int knobWidth = 80;
+    const int rowHeight = 110;
+    const int rowSpacing = 115;
+    const int left = 90;
+    int x[NUM_ROWS];
+    for (int row = 0; row < NUM_ROWS; ++row) {
+        x[row] = left;
+    }
+    for (int i = 0; i < knobs.size(); ++i) {
+        const int row = knobRows[i];
+        knobs[i]->setBounds(x[row], 10 + row * rowSpacing, knobWidth, rowHeight);
+        x[row] += knobWidth;
+    }
+    int choicesInRow[NUM_ROWS] = {};
+    for (int i = 0; i < choices.size(); ++i) {
+        const int row = choiceRows[i];
+        const int column = choicesInRow[row] / 2;
+        const int y = 10 + row * rowSpacing + (choicesInRow[row] % 2) * 54 + 20;
+        choices[i]->setBounds(x[row] + 10 + column * 140, y, 130, 26);
+        ++choicesInRow[row];
+    }
+    // The buttons and the status after the morph row's choices
+    const int buttonsX = x[3] + 10 + ((choicesInRow[3] + 1) / 2) * 140;
+    const int buttonsY = 10 + 3 * rowSpacing + 20;
+    morphButton.setBounds(buttonsX, buttonsY, 80, 26);
+    polyModeButton.setBounds(buttonsX, buttonsY + 54, 80, 26);
+    midiLearnButton.setBounds(buttonsX + 90, buttonsY, 100, 26);
+    // The options on the same line
+    int optionX = buttonsX + 200;
+    for (auto* option : { &multiTimbralButton, &fixedRenderRateButton, &releaseOnProgramChangeButton }) {
+        option->setBounds(optionX, buttonsY, 90, 26);
+        optionX += 96;
+    }
+    statusArea = juce::Rectangle<int>(buttonsX + 90, buttonsY + 54, getWidth() - buttonsX - 100, 26);
+    presetBrowser.setBounds(20, 480, getWidth() - 40, 210);
+    analyser.setBounds(20, 700, getWidth() - 40, 145);
+}
+
+void JX11AudioProcessorEditor::addKnob(const juce::ParameterID& id, const juce::String& label, int row) {
+    auto* knob = knobs.add(new RotaryKnob());
+    knob->label = label;
+    addAndMakeVisible(knob);
+    attachments.attach(knob->slider, id);
+    knobRows.add(row);
+}
+
+void JX11AudioProcessorEditor::addChoice(const juce::ParameterID& id, const juce::String& label, int row) {
+    auto* comboBox = choices.add(new juce::ComboBox());
+    addAndMakeVisible(comboBox);
+    attachments.attach(*comboBox, id);
+    auto* comboLabel = choiceLabels.add(new juce::Label({}, label));
+    comboLabel->attachToComponent(comboBox, false);
+    addAndMakeVisible(comboLabel);
+    choiceRows.add(row);
+}
+
+void JX11AudioProcessorEditor::addOption(juce::TextButton& button, const juce::String& text, std::function<void(bool)> setOption) {
+    button.setButtonText(text);
+    button.setClickingTogglesState(true);
+    button.onClick = [&button, setOption] { setOption(button.getToggleState()); };
+    addAndMakeVisible(button);
+}
+
+void JX11AudioProcessorEditor::updateOptions() {
+    multiTimbralButton.setToggleState(audioProcessor.isMultiTimbral(), juce::dontSendNotification);
+    fixedRenderRateButton.setToggleState(audioProcessor.isFixedRenderRate(), juce::dontSendNotification);
+    releaseOnProgramChangeButton.setToggleState(audioProcessor.isReleaseOnProgramChange(), juce::dontSendNotification);
 }
 
 void JX11AudioProcessorEditor::buttonClicked(juce::Button* button) {
     button->setButtonText("Waiting...");
     button->setEnabled(false);
-    audioProcessor.midiLearn = true;
-    startTimerHz(10);
+    audioProcessor.startMidiLearn();
+    learning = true;
 }
 
 void JX11AudioProcessorEditor::timerCallback() {
-    if (!audioProcessor.midiLearn) {
-        stopTimer();
+    // Only the newest frame matters, except for the peak and a learned CC
+    bool learned = false;
+    outputPeak *= 0.7f;
+    TelemetryFrame frame;
+    while (audioProcessor.getTelemetry().pop(frame)) {
+        telemetry = frame;
+        outputPeak = std::max(outputPeak, frame.outputPeak);
+        learned = learned || frame.learnedCC >= 0;
+    }
+    // Learning can also be called off by a reset, without a CC
+    if (learning && (learned || !audioProcessor.midiLearn)) {
+        learning = false;
         midiLearnButton.setButtonText("MIDI Learn");
         midiLearnButton.setEnabled(true);
     }
+    updateOptions();
+    // Below -60 dB the decaying peak would change the text on every tick
+    // The knobs' paint time is added up over a second, it's too spiky per tick
+    knobPaintTotal += globalLNF.takeKnobPaintMilliseconds();
+    if (++knobPaintTicks >= 30) {
+        knobPaintPerSecond = knobPaintTotal;
+        knobPaintTotal = 0.0;
+        knobPaintTicks = 0;
+    }
+    juce::String peak = outputPeak > 0.001f ? juce::String(juce::Decibels::gainToDecibels(outputPeak), 1) + " dB" : "-inf";
+    // Controls is how long the attachments' last refresh took, Knob paint is the time
+    // spent in LookAndFeel::drawRotarySlider
+    juce::String text = "Voices " + juce::String(telemetry.activeVoices)
+                      + "   CPU " + juce::String(juce::roundToInt(telemetry.cpuLoad * 100.0f)) + "%"
+                      + "   Peak " + peak
+                      + "   Controls " + juce::String(attachments.getLastRefreshMilliseconds(), 1) + " ms"
+                      + "   Knob paint " + juce::String(knobPaintPerSecond, 1) + " ms/s";
+    // Nothing to paint if it reads the same
+    if (text != statusText) {
+        statusText = text;
+        repaint(statusArea);
+    }
 }
@@ -13,6 +13,9 @@
 #include "Parameters.h"
 #include "RotaryKnob.h"
 #include "LookAndFeel.h"
+#include "PresetBrowser.h"
+#include "Analyser.h"
+#include "ParameterAttachments.h"
 
 //==============================================================================
 /**
@@ -31,37 +34,46 @@ private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     JX11AudioProcessor& audioProcessor;
-    using APVTS = juce::AudioProcessorValueTreeState;
-    using SliderAttachment = APVTS::SliderAttachment;
-    using ButtonAttachment = APVTS::ButtonAttachment;
     void buttonClicked(juce::Button* button) override;
     void timerCallback() override;
+    void addKnob(const juce::ParameterID& id, const juce::String& label, int row);
+    void addChoice(const juce::ParameterID& id, const juce::String& label, int row);
+    // A toggle for one of the processor's options, which aren't parameters
+    void addOption(juce::TextButton& button, const juce::String& text, std::function<void(bool)> setOption);
+    // The host can change the options by loading a state
+    void updateOptions();
+    // The latest from the audio thread, drained from the telemetry queue by the timer
+    TelemetryFrame telemetry;
+    float outputPeak = 0.0f;
+    bool learning = false;
+    juce::Rectangle<int> statusArea;
+    juce::String statusText;
+    double knobPaintTotal = 0.0;
+    double knobPaintPerSecond = 0.0;
+    int knobPaintTicks = 0;
     //=============================================================
     // The UI Elements
     //=============================================================
     LookAndFeel globalLNF;
-    RotaryKnob outputLevelKnob;
-    RotaryKnob filterResoKnob;
+    // Every parameter has a control, in rows: oscillators, filter, amp and modulation, morph
+    static constexpr int NUM_ROWS = 4;
+    juce::OwnedArray<RotaryKnob> knobs;
+    juce::Array<int> knobRows;
+    juce::OwnedArray<juce::ComboBox> choices;
+    juce::OwnedArray<juce::Label> choiceLabels;
+    juce::Array<int> choiceRows;
     juce::TextButton polyModeButton;
+    juce::TextButton morphButton;
     juce::TextButton midiLearnButton;
+    juce::TextButton multiTimbralButton;
+    juce::TextButton fixedRenderRateButton;
+    juce::TextButton releaseOnProgramChangeButton;
+    PresetBrowser presetBrowser { audioProcessor };
+    Analyser analyser { audioProcessor };
     //=============================================================
-    // The Attachments
+    // The Attachments (after the controls, so they go first)
     //=============================================================
-    SliderAttachment outputLevelAttachment {
-        audioProcessor.apvts,
-        ParameterID::outputLevel.getParamID(),
-        outputLevelKnob.slider
-    };
-    SliderAttachment filterResoAttachment {
-        audioProcessor.apvts,
-        ParameterID::filterReso.getParamID(),
-        filterResoKnob.slider
-    };
-    ButtonAttachment polyModeAttachment {
-        audioProcessor.apvts,
-        ParameterID::polyMode.getParamID(),
-        polyModeButton
-    };
+    ParameterAttachments attachments { audioProcessor.apvts };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JX11AudioProcessorEditor)
 };
@@ -26,11 +26,21 @@ JX11AudioProcessor::JX11AudioProcessor()
 #endif
 {
     // MYR Added: initialize the parameters with the APVTS
-    synth.params.initParams(apvts);
+    parameters.initParams(apvts);
     apvts.state.addListener(this);
-    // Must be after the APVTS initialization
-    synth.params.createDefaultPresets();
-    setCurrentProgram(0);
+    // The parameter defaults are the Init preset, so there's no need to set them again
+    // (and tell the host about every one of them).  The synth is reset in prepareToPlay
+    jassert(parameters.matchesPreset(0));
+    currentProgram = 0;
+    for (auto* parameter : getParameters()) {
+        parameter->addListener(this);
+    }
+    // CC 71 has always been the resonance
+    lastTouchedParameter = parameters.indexOf(ParameterID::filterReso);
+    MidiCCMap::Mapping resonance;
+    resonance.parameter = lastTouchedParameter;
+    ccMap.set(0x47, resonance);
+    startTimerHz(30);
 //    juce::String str("Hello World!");
 //    DBG(str);
 //    std::string test = str.toStdString();
@@ -39,6 +49,10 @@ JX11AudioProcessor::JX11AudioProcessor()
 
 JX11AudioProcessor::~JX11AudioProcessor()
 {
+    stopTimer();
+    for (auto* parameter : getParameters()) {
+        parameter->removeListener(this);
+    }
     apvts.state.removeListener(this);
 }
 
@@ -80,9 +94,10 @@ double JX11AudioProcessor::getTailLengthSeconds() const
     return 0.0;
 }
 
+// The factory presets, then the user presets
 int JX11AudioProcessor::getNumPrograms()
 {
-    return int(synth.params.presets.size());
+    return Parameters::totalPresets() + userPresets.size();
 }
 
 int JX11AudioProcessor::getCurrentProgram()
@@ -91,42 +106,224 @@ int JX11AudioProcessor::getCurrentProgram()
 }
 
 void JX11AudioProcessor::setCurrentProgram (int index) {
+    float values[NUM_PARAMS];
+    if (index >= Parameters::totalPresets()) {
+        const juce::ScopedLock lock(userPresets.getLock());
+        const int userIndex = index - Parameters::totalPresets();
+        // Not there (yet)
+        if (userIndex >= userPresets.size()) {
+            return;
+        }
+        const auto& record = userPresets.record(userIndex);
+        std::copy(record.param, record.param + NUM_PARAMS, values);
+    }
     currentProgram = index;
+    // The host's choice wins over a Program Change that hasn't been passed on yet
+    pendingProgram.store(-1);
     
-    synth.params.setCurrentProgram(index);
+    if (index < Parameters::totalPresets()) {
+        parameters.setCurrentProgram(index);
+    } else {
+        parameters.setPresetValues(values);
+    }
     
-    reset();
+    // Same as a MIDI Program Change.  The voices belong to the audio thread, so it does
+    // the releasing at the start of the next block
+    if (releaseOnProgramChange.load()) {
+        pendingRelease.store(true);
+    } else {
+        reset();
+    }
 }
 
 const juce::String JX11AudioProcessor::getProgramName (int index)
 {
-    return {synth.params.presets[index].name};
+    if (index < Parameters::totalPresets()) {
+        return {Parameters::preset(index).name};
+    }
+    const juce::ScopedLock lock(userPresets.getLock());
+    const int userIndex = index - Parameters::totalPresets();
+    return userIndex < userPresets.size() ? userPresets.getName(userIndex) : juce::String();
 }
 
-void JX11AudioProcessor::changeProgramName (int /*index*/, const juce::String& /*newName*/)
+// Only the user presets can be renamed.  The timer does it, on the message thread
+void JX11AudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
-    // Not implemented
+    if (index >= Parameters::totalPresets()) {
+        const juce::ScopedLock lock(userPresetLock);
+        pendingRenameIndex = index - Parameters::totalPresets();
+        pendingRenameName = newName;
+    }
+}
+
+UserPresetBank& JX11AudioProcessor::getUserPresets() {
+    JUCE_ASSERT_MESSAGE_THREAD
+    // Only tried once, a bank that won't open stays empty
+    if (!userPresetsOpened.load()) {
+        userPresets.open(UserPresetBank::getDefaultFile());
+        userPresetsOpened.store(true);
+        if (userPresets.size() > 0) {
+            updateHostDisplay(ChangeDetails().withProgramChanged(true));
+        }
+    }
+    return userPresets;
+}
+
+bool JX11AudioProcessor::refreshUserPresets() {
+    if (!getUserPresets().refresh()) {
+        return false;
+    }
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+    return true;
+}
+
+int JX11AudioProcessor::saveUserPreset(const juce::String& name, const juce::String& category) {
+    float values[NUM_PARAMS];
+    parameters.getPresetValues(values);
+    UserPresetBank& bank = getUserPresets();
+    const int index = bank.append(name, category, values);
+    if (index >= 0) {
+        currentProgram = Parameters::totalPresets() + index;
+        updateHostDisplay(ChangeDetails().withProgramChanged(true));
+    }
+    return index;
+}
+
+PresetPreviews& JX11AudioProcessor::getPresetPreviews() {
+    // Starts a worker thread, so not in the constructor either
+    if (presetPreviews == nullptr) {
+        presetPreviews = std::make_unique<PresetPreviews>();
+    }
+    return *presetPreviews;
+}
+
+bool JX11AudioProcessor::playPreview(PresetPreviews::Buffer preview) {
+    return previewPlayer.play(std::move(preview), PresetPreviews::SAMPLE_RATE);
+}
+
+void JX11AudioProcessor::stopPreview() {
+    previewPlayer.stop();
 }
 
 //==============================================================================
 void JX11AudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    synth.allocateResources(sampleRate, samplesPerBlock);
-    parametersChanged.store(true);
+    // Work out the rate the synth actually runs at.  The multi-timbral parts don't upsample
+    multiTimbralActive = multiTimbral.load();
+    renderFactor = (fixedRenderRate.load() && !multiTimbralActive) ? Upsampler::factorForRate(sampleRate) : 1;
+    renderSampleRate = sampleRate / double(renderFactor);
+    int internalBlockSize = samplesPerBlock / renderFactor + 1;
+    for (auto& upsampler : upsamplers) {
+        upsampler.prepare(renderFactor);
+    }
+    internalBuffer.setSize(2, internalBlockSize);
+    upsampledBuffer.setSize(2, internalBlockSize * renderFactor);
+    setLatencySamples(upsamplers[0].getLatency());
+    // The previews are resampled to the host rate, not the render rate
+    previewPlayer.prepare(sampleRate);
+    loadMeasurer.reset(sampleRate, samplesPerBlock);
+    telemetryInterval = juce::jmax(1, int(sampleRate / TELEMETRY_RATE));
+    telemetrySamples = 0;
+    morphSmoother.reset(sampleRate, MORPH_GLIDE_SECONDS);
+    morphSmoother.setCurrentAndTargetValue(parameters.getMorphPosition());
+    
+    synth.allocateResources(renderSampleRate, internalBlockSize);
+    parameters.buildPresetSnapshots(float(renderSampleRate));
+    prepareParts(samplesPerBlock);
+    // Before the reset, so the output level starts where it should
+    updateRenderParams();
+    parametersChanged.store(false);
     reset();
+    prepared.store(true);
 }
 
 void JX11AudioProcessor::releaseResources()
 {
+    prepared.store(false);
     synth.deallocateResources();
+    for (auto& part : parts) {
+        if (part.ownSynth != nullptr) {
+            part.ownSynth->deallocateResources();
+        }
+    }
+}
+
+void JX11AudioProcessor::prepareParts(int samplesPerBlock) {
+    if (!multiTimbralActive) {
+        partPool.stop();
+        for (auto& part : parts) {
+            part.synth = nullptr;
+            part.ownSynth.reset();
+            part.buffer.setSize(0, 0);
+        }
+        synth.setVoiceLimit(MAX_VOICES);
+        return;
+    }
+    parts[0].synth = &synth;
+    for (int i = 0; i < NUM_PARTS; ++i) {
+        Part& part = parts[size_t(i)];
+        if (i > 0) {
+            if (part.ownSynth == nullptr) {
+                part.ownSynth = std::make_unique<Synth>();
+            }
+            part.synth = part.ownSynth.get();
+            part.synth->allocateResources(renderSampleRate, samplesPerBlock);
+            part.synth->reset();
+        }
+        part.buffer.setSize(2, samplesPerBlock);
+        part.outputLevel = -1.0f;
+    }
+    updatePartParams();
+    // The audio thread renders parts too, so one thread fewer than the cores
+    partPool.start(juce::jlimit(0, NUM_PARTS - 1, juce::SystemStats::getNumCpus() - 1),
+                   1000.0 * samplesPerBlock / getSampleRate());
+}
+
+void JX11AudioProcessor::updatePartParams() {
+    for (int i = 1; i < NUM_PARTS; ++i) {
+        Part& part = parts[size_t(i)];
+        RenderParams renderParams = parameters.presetSnapshot(part.program.load());
+        if (part.outputLevel >= 0.0f) {
+            renderParams.outputLevel = part.outputLevel;
+        }
+        part.synth->setParams(renderParams);
+    }
 }
 
 // MYR added this function
 void JX11AudioProcessor::reset() {
     synth.reset();
+    for (auto& upsampler : upsamplers) {
+        upsampler.reset();
+    }
+    pendingCount = 0;
+    pendingOffset = 0;
     midiLearn = false;
 }
 
+void JX11AudioProcessor::setFixedRenderRate(bool shouldBeFixed) {
+    fixedRenderRate.store(shouldBeFixed);
+}
+
+void JX11AudioProcessor::setReleaseOnProgramChange(bool shouldRelease) {
+    releaseOnProgramChange.store(shouldRelease);
+}
+
+void JX11AudioProcessor::setMultiTimbral(bool shouldBeMultiTimbral) {
+    multiTimbral.store(shouldBeMultiTimbral);
+}
+
+void JX11AudioProcessor::prepareAgain() {
+    JUCE_ASSERT_MESSAGE_THREAD
+    if (!prepared.load()) {
+        return;
+    }
+    // Waits for the block in progress, and the host gets silence until it's done
+    suspendProcessing(true);
+    prepareToPlay(getSampleRate(), getBlockSize());
+    suspendProcessing(false);
+}
+
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool JX11AudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
@@ -156,12 +353,7 @@ bool JX11AudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) con
 void JX11AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
-    
-    // Read the parameters here:
-    const juce::String& paramID = ParameterID::noise.getParamID();
-    float noiseMix = apvts.getRawParameterValue(paramID) -> load() / 100.0f;
-    noiseMix *= noiseMix;
-    synth.params.noiseMix = noiseMix * 0.06f;
+    juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer(loadMeasurer, buffer.getNumSamples());
     
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -169,13 +361,54 @@ void JX11AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::M
     // Clear any output channels that don't contain input data.
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i) { buffer.clear(i, 0, buffer.getNumSamples());
     }
+    ccMap.beginBlock();
+    // Doesn't do anything if it hasn't changed.  render() takes care of the gliding
+    morphSmoother.setTargetValue(parameters.getMorphPosition());
     // For updating the parameters in a thread-safe way:
     bool expected = true;
     if (isNonRealtime() || parametersChanged.compare_exchange_strong(expected, false)) {
-        synth.params.updateParams(getSampleRate());
+        updateRenderParams();
+        if (multiTimbralActive) {
+            updatePartParams();
+        }
+    }
+    if (pendingRelease.exchange(false)) {
+        synth.releaseAllVoices();
     }
     
-    splitBufferByEvents(buffer, midiMessages);
+    if (multiTimbralActive) {
+        processParts(buffer, midiMessages);
+    } else {
+        splitBufferByEvents(buffer, midiMessages);
+    }
+    // Before the preview, the analyser is for the synth
+    analyserFifo.push(buffer);
+    previewPlayer.addTo(buffer);
+    ccMap.endBlock();
+    sendTelemetry(buffer);
+}
+
+void JX11AudioProcessor::sendTelemetry(const juce::AudioBuffer<float>& buffer) {
+    if (!telemetry.isActive()) {
+        telemetrySamples = 0;
+        return;
+    }
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+        telemetryFrame.outputPeak = std::max(telemetryFrame.outputPeak, buffer.getMagnitude(ch, 0, buffer.getNumSamples()));
+    }
+    telemetrySamples += buffer.getNumSamples();
+    if (telemetrySamples < telemetryInterval) {
+        return;
+    }
+    telemetrySamples = 0;
+    telemetryFrame.activeVoices = synth.getVoiceStates(telemetryFrame.notes, telemetryFrame.envelopeLevels);
+    telemetryFrame.cpuLoad = float(loadMeasurer.getLoadAsProportion());
+    telemetryFrame.learnedCC = telemetryLearnedCC;
+    // If the queue is full, the peak and the learned CC go in the next one
+    if (telemetry.push(telemetryFrame)) {
+        telemetryFrame.outputPeak = 0.0f;
+        telemetryLearnedCC = -1;
+    }
 }
 
 // Function added by MYR to split the buffer and handle each MIDI event as it comes in!
@@ -206,39 +439,315 @@ void JX11AudioProcessor::splitBufferByEvents(juce::AudioBuffer<float>& buffer, j
     midiMessages.clear();
 }
 
+// Sorts the block's MIDI out by channel and renders the parts on the pool, a chunk of
+// the block at a time.  Then the parts are added up into the host's buffer
+void JX11AudioProcessor::processParts(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    // The morph moves once per block here, not every MORPH_STEP samples
+    if (morphSmoother.isSmoothing()) {
+        morphSmoother.skip(buffer.getNumSamples());
+        if (parameters.isMorphing()) {
+            updateRenderParams();
+        }
+    }
+    int noteOns[NUM_PARTS] = {};
+    int totalNoteOns = 0;
+    for (auto& part : parts) {
+        part.numEvents = 0;
+        part.nextEvent = 0;
+    }
+    for (const auto metadata : midiMessages) {
+        // Ignore MIDI messages like sysex
+        if (metadata.numBytes > 3) {
+            continue;
+        }
+        uint8_t data0 = metadata.data[0];
+        uint8_t data1 = (metadata.numBytes >= 2) ? metadata.data[1] : 0;
+        uint8_t data2 = (metadata.numBytes == 3) ? metadata.data[2] : 0;
+        // System messages have no channel, they go to the first part
+        const int index = (data0 < 0xF0) ? (data0 & 0x0F) : 0;
+        // Channel 1's Program Change, MIDI learn, mapped CCs and volume are the processor's,
+        // so they're handled here and not on the pool.  They take effect at the start of
+        // the block
+        if (index == 0 && (!handleControlMIDI(data0, data1, data2) || (data0 & 0xF0) == 0xC0)) {
+            continue;
+        }
+        Part& part = parts[size_t(index)];
+        if (part.numEvents < MAX_PART_EVENTS) {
+            part.events[size_t(part.numEvents++)] = { metadata.samplePosition, data0, data1, data2 };
+            if ((data0 & 0xF0) == 0x90 && data2 > 0) {
+                ++noteOns[index];
+                ++totalNoteOns;
+            }
+        }
+    }
+    midiMessages.clear();
+    
+    // Share out the voice budget.  The voices that are sounding keep going, and the
+    // spare ones are split between the parts with note ons this block, in proportion
+    // to how many they have.  So the budget holds, except that a part with no voices
+    // at all can always start one (see Synth::findFreeVoice)
+    int activeVoices[NUM_PARTS];
+    int totalActive = 0;
+    for (int i = 0; i < NUM_PARTS; ++i) {
+        activeVoices[i] = parts[size_t(i)].synth->getActiveVoiceCount();
+        totalActive += activeVoices[i];
+    }
+    const int spareVoices = std::max(0, VOICE_BUDGET - totalActive);
+    int shares[NUM_PARTS];
+    int unshared = spareVoices;
+    for (int i = 0; i < NUM_PARTS; ++i) {
+        shares[i] = (totalNoteOns > 0) ? spareVoices * noteOns[i] / totalNoteOns : 0;
+        unshared -= shares[i];
+    }
+    // What the rounding left over, one each
+    for (int i = 0; i < NUM_PARTS && unshared > 0; ++i) {
+        if (noteOns[i] > shares[i]) {
+            ++shares[i];
+            --unshared;
+        }
+    }
+    partRenderCount = 0;
+    for (int i = 0; i < NUM_PARTS; ++i) {
+        parts[size_t(i)].synth->setVoiceLimit(activeVoices[i] + shares[i]);
+        // A silent part with no MIDI can sit this block out.  The first one has the knobs,
+        // so it always renders
+        if (i == 0 || activeVoices[i] > 0 || parts[size_t(i)].numEvents > 0) {
+            partsToRender[size_t(partRenderCount++)] = i;
+        }
+    }
+    
+    partNumChannels = (getTotalNumOutputChannels() > 1) ? 2 : 1;
+    const int numSamples = buffer.getNumSamples();
+    const int chunkSize = parts[0].buffer.getNumSamples();
+    for (partChunkStart = 0; partChunkStart < numSamples; partChunkStart += chunkSize) {
+        partSampleCount = std::min(chunkSize, numSamples - partChunkStart);
+        partPool.run(renderPartJob, this, partRenderCount);
+        for (int ch = 0; ch < partNumChannels; ++ch) {
+            buffer.copyFrom(ch, partChunkStart, parts[0].buffer, ch, 0, partSampleCount);
+            for (int n = 1; n < partRenderCount; ++n) {
+                buffer.addFrom(ch, partChunkStart, parts[size_t(partsToRender[size_t(n)])].buffer, ch, 0, partSampleCount);
+            }
+        }
+    }
+}
+
+void JX11AudioProcessor::renderPartJob(void* processor, int index) {
+    auto* self = static_cast<JX11AudioProcessor*>(processor);
+    self->renderPart(self->partsToRender[size_t(index)]);
+}
+
+// Like splitBufferByEvents, for one part and the current chunk.  Runs on the pool, so
+// it only touches its own part
+void JX11AudioProcessor::renderPart(int index) {
+    Part& part = parts[size_t(index)];
+    Synth& partSynth = *part.synth;
+    const int chunkEnd = partChunkStart + partSampleCount;
+    int bufferOffset = 0;
+    auto renderUpTo = [&](int offset) {
+        if (offset > bufferOffset) {
+            float* outputBuffers[2] = {
+                part.buffer.getWritePointer(0) + bufferOffset,
+                (partNumChannels > 1) ? part.buffer.getWritePointer(1) + bufferOffset : nullptr
+            };
+            partSynth.render(outputBuffers, offset - bufferOffset);
+            bufferOffset = offset;
+        }
+    };
+    
+    while (part.nextEvent < part.numEvents && part.events[size_t(part.nextEvent)].position < chunkEnd) {
+        const PartEvent& event = part.events[size_t(part.nextEvent++)];
+        renderUpTo(event.position - partChunkStart);
+        if (index == 0) {
+            // processParts already took care of channel 1's controls
+            partSynth.midiMessage(event.data0, event.data1, event.data2);
+            continue;
+        }
+        const uint8_t type = event.data0 & 0xF0;
+        if (type == 0xC0) {
+            if (event.data1 < Parameters::totalPresets()) {
+                part.program.store(event.data1);
+                part.outputLevel = -1.0f;
+                partSynth.setParams(parameters.presetSnapshot(event.data1));
+                if (releaseOnProgramChange.load()) {
+                    partSynth.releaseAllVoices();
+                } else {
+                    partSynth.reset();
+                }
+            }
+            continue;
+        }
+        if (type == 0xB0 && event.data1 == 0x07) {
+            part.outputLevel = parameters.outputLevelToGain(float(event.data2) / 127.0f);
+            partSynth.setOutputLevel(part.outputLevel);
+        }
+        partSynth.midiMessage(event.data0, event.data1, event.data2);
+    }
+    renderUpTo(partSampleCount);
+}
+
 // Function added by MYR to deal with the incoming MIDI
 void JX11AudioProcessor::handleMIDI(uint8_t data0, uint8_t data1, uint8_t data2) {
+    if (handleControlMIDI(data0, data1, data2)) {
+        synth.midiMessage(data0, data1, data2);
+    }
+}
+
+bool JX11AudioProcessor::handleControlMIDI(uint8_t data0, uint8_t data1, uint8_t data2) {
 //    char s[16];
 //    snprintf(s, 16, "%02hhX %02hhX %02hhX", data0, data1, data2);
 //    DBG(s);
     // MIDI Learn is active:
-    if (midiLearn && ((data0 & 0xF0) == 0xB0)) {
+    if (midiLearn && ((data0 & 0xF0) == 0xB0) && data1 < MidiCCMap::FIRST_MODE_MESSAGE) {
         DBG("Learned a MIDI CC");
-        synth.resoCC = data1;
+        learnedCC.store(data1);
+        telemetryLearnedCC = data1;
         midiLearn = false;
-        return;
+        return false;
     }
     
     // Control Change:
     if ((data0 & 0xF0) == 0xB0) {
+        if (handleMappedCC(data1, data2)) {
+            return false;
+        }
         if (data1 == 0x07) {
             // Volume
             float volumeCtl = float(data2) / 127.0f;
-            synth.params.changeOutputLevelNotifyHost(volumeCtl);
+            synth.setOutputLevel(parameters.outputLevelToGain(volumeCtl));
+            pendingOutputLevel.store(volumeCtl);
         }
     }
     // Program Change message:
     if ((data0 & 0xF0) == 0xC0) {
-        if (data1 < synth.params.totalPresets()) {
-            setCurrentProgram(data1);
+        if (data1 < parameters.totalPresets()) {
+            switchProgram(data1);
         }
     }
-    
-    synth.midiMessage(data0, data1, data2);
+    return true;
+}
+
+// A mapped CC changes the synth right away, at its position in the block.  The
+// host hears about it from the timer
+bool JX11AudioProcessor::handleMappedCC(uint8_t cc, uint8_t value) {
+    const MidiCCMap::Mapping& mapping = ccMap.lookup(cc);
+    if (!mapping.isMapped()) {
+        return false;
+    }
+    parameters.setFromMidi(mapping.parameter, mapping.apply(value));
+    morphSmoother.setTargetValue(parameters.getMorphPosition());
+    updateRenderParams();
+    return true;
+}
+
+void JX11AudioProcessor::startMidiLearn() {
+    learnParameter.store(lastTouchedParameter);
+    learnedCC.store(-1);
+    midiLearn = true;
+}
+
+void JX11AudioProcessor::parameterGestureChanged(int parameterIndex, bool gestureIsStarting) {
+    if (gestureIsStarting && !notifyingHost && juce::MessageManager::existsAndIsCurrentThread()) {
+        lastTouchedParameter = parameterIndex;
+    }
+}
+
+// The parameters still have the old preset's values until the timer catches up,
+// so a pending Program Change keeps the synth on the new preset's snapshot.
+// The morph overrides both
+void JX11AudioProcessor::updateRenderParams() {
+    int program = pendingProgram.load();
+    RenderParams renderParams;
+    if (parameters.isMorphing()) {
+        renderParams = parameters.makeMorphParams(morphSmoother.getCurrentValue(), float(renderSampleRate));
+    } else if (program >= 0) {
+        renderParams = parameters.presetSnapshot(program);
+    } else {
+        renderParams = parameters.makeRenderParams(float(renderSampleRate));
+    }
+    // Don't undo a MIDI volume change before the parameter has caught up with it
+    float pending = pendingOutputLevel.load();
+    if (pending >= 0.0f) {
+        renderParams.outputLevel = parameters.outputLevelToGain(pending);
+    }
+    synth.setParams(renderParams);
+}
+
+void JX11AudioProcessor::switchProgram(int index) {
+    currentProgram = index;
+    // The new preset has its own output level
+    pendingOutputLevel.store(-1.0f);
+    pendingProgram.store(index);
+    // No host notification here, just copy the snapshot.  It takes effect at the
+    // Program Change's position in the block
+    updateRenderParams();
+    if (releaseOnProgramChange.load()) {
+        synth.releaseAllVoices();
+    } else {
+        reset();
+    }
+}
+
+void JX11AudioProcessor::timerCallback() {
+    bool renamed = false;
+    {
+        // The host only knows about user presets once the bank is open, so a rename
+        // before that is for one that isn't there
+        const juce::ScopedLock lock(userPresetLock);
+        if (pendingRenameIndex >= 0 && userPresetsOpened.load()) {
+            renamed = userPresets.rename(pendingRenameIndex, pendingRenameName);
+        }
+        pendingRenameIndex = -1;
+    }
+    if (renamed) {
+        updateHostDisplay(ChangeDetails().withProgramChanged(true));
+    }
+
+    int cc = learnedCC.exchange(-1);
+    int parameter = learnParameter.load();
+    if (cc >= 0 && parameter >= 0) {
+        // A CC only goes to one parameter, learning it again moves it
+        MidiCCMap::Mapping mapping;
+        mapping.parameter = parameter;
+        ccMap.set(cc, mapping);
+    }
+    ccMap.collectGarbage();
+
+    const juce::ScopedValueSetter<bool> svs(notifyingHost, true);
+    // Tell the host about the preset first, it sets the output level too
+    int program = pendingProgram.load();
+    if (program >= 0) {
+        parameters.setCurrentProgram(program);
+        pendingProgram.compare_exchange_strong(program, -1);
+    }
+    float pending = pendingOutputLevel.load();
+    if (pending >= 0.0f) {
+        parameters.changeOutputLevelNotifyHost(pending);
+        // Only clear it if another CC hasn't come in since
+        pendingOutputLevel.compare_exchange_strong(pending, -1.0f);
+    }
+    parameters.notifyHostOfMidiValues();
 }
 
 // Function added by MYR to render audio to the buffer from each MIDI event
 void JX11AudioProcessor::render(juce::AudioBuffer<float> &buffer, int sampleCount, int bufferOffset) {
+    // Step the morph along in small pieces, so a sweep doesn't zipper.  The voices
+    // keep going, only the snapshot changes
+    while (morphSmoother.isSmoothing() && sampleCount > 0) {
+        int samplesThisStep = std::min(sampleCount, MORPH_STEP);
+        morphSmoother.skip(samplesThisStep);
+        if (parameters.isMorphing()) {
+            updateRenderParams();
+        }
+        renderSegment(buffer, samplesThisStep, bufferOffset);
+        sampleCount -= samplesThisStep;
+        bufferOffset += samplesThisStep;
+    }
+    if (sampleCount > 0) {
+        renderSegment(buffer, sampleCount, bufferOffset);
+    }
+}
+
+void JX11AudioProcessor::renderSegment(juce::AudioBuffer<float> &buffer, int sampleCount, int bufferOffset) {
     float* outputBuffers[2] = {nullptr, nullptr};
     outputBuffers[0] = buffer.getWritePointer(0) + bufferOffset;
     // If we need stereo sound
@@ -246,7 +755,51 @@ void JX11AudioProcessor::render(juce::AudioBuffer<float> &buffer, int sampleCoun
         outputBuffers[1] = buffer.getWritePointer(1) + bufferOffset;
     }
     
-    synth.render(outputBuffers, sampleCount);
+    if (renderFactor > 1) {
+        renderUpsampled(outputBuffers, sampleCount);
+    } else {
+        synth.render(outputBuffers, sampleCount);
+    }
+}
+
+// Renders the synth at the internal rate and upsamples it into the host buffer.
+// The synth can only render whole internal samples, so any extra upsampled samples
+// are kept for the start of the next segment (MIDI timing moves by less than renderFactor samples)
+void JX11AudioProcessor::renderUpsampled(float** outputBuffers, int sampleCount) {
+    const int numChannels = (outputBuffers[1] != nullptr) ? 2 : 1;
+    int written = 0;
+    
+    // Use up what was left over from the last segment first
+    while (pendingCount > 0 && written < sampleCount) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            outputBuffers[ch][written] = pendingSamples[ch][pendingOffset];
+        }
+        ++pendingOffset;
+        --pendingCount;
+        ++written;
+    }
+    
+    while (written < sampleCount) {
+        int remaining = sampleCount - written;
+        int internalCount = std::min((remaining + renderFactor - 1) / renderFactor, internalBuffer.getNumSamples());
+        float* internalBuffers[2] = {
+            internalBuffer.getWritePointer(0),
+            (numChannels > 1) ? internalBuffer.getWritePointer(1) : nullptr
+        };
+        synth.render(internalBuffers, internalCount);
+        
+        int upsampledCount = internalCount * renderFactor;
+        int samplesToCopy = std::min(upsampledCount, remaining);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* upsampled = upsampledBuffer.getWritePointer(ch);
+            upsamplers[ch].process(internalBuffers[ch], upsampled, internalCount);
+            std::copy(upsampled, upsampled + samplesToCopy, outputBuffers[ch] + written);
+            std::copy(upsampled + samplesToCopy, upsampled + upsampledCount, pendingSamples[ch]);
+        }
+        pendingCount = upsampledCount - samplesToCopy;
+        pendingOffset = 0;
+        written += samplesToCopy;
+    }
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout JX11AudioProcessor::createParameterLayout() {
@@ -443,6 +996,78 @@ juce::AudioProcessorValueTreeState::ParameterLayout JX11AudioProcessor::createPa
        juce::NormalisableRange<float>(-24.0f, 6.0f, 0.1f),
        0.0f,
        juce::AudioParameterFloatAttributes().withLabel("dB")));
+    // Parameters added since the first release go after the original ones, so hosts that
+    // address parameters by index still find the old ones where they were
+    // BLIT is the original sound, PolyBLEP is the cheapest, the wavetable and BLIT table alias the least
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::oscEngine,
+        "Osc Engine",
+        juce::StringArray {"BLIT", "PolyBLEP", "Wavetable", "BLIT Table"},
+        0));
+    // The SVF is the original filter.  The ladder is a 24dB slope, and Ladder Drive saturates
+    // in the feedback loop.  The ladder costs about 3x the SVF to render, and Ladder Drive about 10x
+    // (see LadderFilter.h)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::filterType,
+        "Filter Type",
+        juce::StringArray {"SVF LP", "SVF BP", "SVF HP", "Ladder", "Ladder Drive"},
+        0));
+    // Not part of the presets, it's a quality setting.  Each voice only switches it on when
+    // its filter is bright or resonant enough to need it
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::filterOversampling,
+        "Filter Oversampling",
+        juce::StringArray {"Off", "2x", "4x"},
+        0));
+    // Also a quality setting. Table skips the exp and tan per voice per update, at a
+    // small cost in accuracy (see FilterCoefficientTable.h)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::filterCoefficients,
+        "Filter Coefficients",
+        juce::StringArray {"Exact", "Table"},
+        0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::lfoWave,
+        "LFO Wave",
+        juce::StringArray {"Sine", "Triangle", "Saw", "S&H"},
+        0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::noiseType,
+        "Noise Type",
+        juce::StringArray {"White", "Pink", "Brown"},
+        0));
+    // Per Voice gives every voice its own noise, so it spreads out across the stereo field
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::noiseSpread,
+        "Noise Spread",
+        juce::StringArray {"Shared", "Per Voice"},
+        0));
+    // Morph between two factory presets.  Not part of the presets
+    juce::StringArray presetNames;
+    for (const Preset& preset : FACTORY_PRESETS) {
+        presetNames.add(preset.name);
+    }
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::morph,
+        "Morph",
+        juce::StringArray {"Off", "On"},
+        0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::morphA,
+        "Morph A",
+        presetNames,
+        0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::morphB,
+        "Morph B",
+        presetNames,
+        1));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+       ParameterID::morphPosition,
+       "Morph Position",
+       juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f),
+       0.0f,
+       juce::AudioParameterFloatAttributes().withLabel("%")));
     return layout;
 }
 
@@ -462,19 +1087,171 @@ juce::AudioProcessorEditor* JX11AudioProcessor::createEditor()
 }
 
 //==============================================================================
+// The state is the binary format in PluginState.h.  A counting pass works out the
+// size, so the only allocation is destData itself
 void JX11AudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    auto xml = std::make_unique<juce::XmlElement>(pluginTag);
-    std::unique_ptr<juce::XmlElement> parametersXML(apvts.copyState().createXml());
-    xml->addChildElement(parametersXML.release());
-    
-    copyXmlToBinary(*xml, destData);
+    // The host can ask from any thread, so the CC map could change between the passes.
+    // Both work from the same copy, or the sizes wouldn't match
+    MidiCCMap::Mapping mappings[MidiCCMap::NUM_CCS];
+    ccMap.getAll(mappings);
+    PluginState::Writer counter;
+    writeState(counter, mappings);
+    destData.setSize(counter.size());
+    PluginState::Writer writer(static_cast<uint8_t*>(destData.getData()), destData.getSize());
+    writeState(writer, mappings);
 }
 
 void JX11AudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+    if (PluginState::Reader::hasHeader(data, size_t(sizeInBytes))) {
+        readBinaryState(data, sizeInBytes);
+    } else {
+        // Sessions saved before the binary format
+        readLegacyState(data, sizeInBytes);
+    }
+}
+
+void JX11AudioProcessor::writeState(PluginState::Writer& writer, const MidiCCMap::Mapping (&mappings)[MidiCCMap::NUM_CCS]) const {
+    writer.writeHeader();
+    parameters.writeState(writer);
+    writer.beginChunk(PluginState::CHUNK_PROGRAM);
+    writer.writeI32(int32_t(currentProgram));
+    writer.endChunk();
+    writer.beginChunk(PluginState::CHUNK_CC_MAP);
+    uint32_t mappedCount = 0;
+    for (int cc = 0; cc < MidiCCMap::NUM_CCS; ++cc) {
+        mappedCount += mappings[cc].isMapped() ? 1 : 0;
+    }
+    writer.writeU32(mappedCount);
+    for (int cc = 0; cc < MidiCCMap::NUM_CCS; ++cc) {
+        const MidiCCMap::Mapping& mapping = mappings[cc];
+        if (mapping.isMapped()) {
+            writer.writeU8(uint8_t(cc));
+            writer.writeU32(parameters.idHashOf(mapping.parameter));
+            writer.writeFloat(mapping.rangeStart);
+            writer.writeFloat(mapping.rangeEnd);
+            writer.writeU8(mapping.curve);
+        }
+    }
+    writer.endChunk();
+    writer.beginChunk(PluginState::CHUNK_PARTS);
+    writer.writeU32(uint32_t(NUM_PARTS - 1));
+    for (int i = 1; i < NUM_PARTS; ++i) {
+        writer.writeI32(int32_t(parts[size_t(i)].program.load()));
+    }
+    writer.endChunk();
+    uint32_t options = 0;
+    if (fixedRenderRate.load()) {
+        options |= PluginState::OPTION_FIXED_RENDER_RATE;
+    }
+    if (releaseOnProgramChange.load()) {
+        options |= PluginState::OPTION_RELEASE_ON_PROGRAM_CHANGE;
+    }
+    if (multiTimbral.load()) {
+        options |= PluginState::OPTION_MULTI_TIMBRAL;
+    }
+    writer.beginChunk(PluginState::CHUNK_OPTIONS);
+    writer.writeU32(options);
+    writer.endChunk();
+    writer.beginChunk(PluginState::CHUNK_SOUND_VERSION);
+    writer.writeI32(int32_t(parameters.getSoundVersion()));
+    writer.endChunk();
+}
+
+void JX11AudioProcessor::readBinaryState(const void* data, int sizeInBytes) {
+    PluginState::Reader reader(data, size_t(sizeInBytes));
+    if (reader.readHeader() == 0) {
+        return;
+    }
+    // The binary format came after the control rate modulation, the release fix and
+    // the new noise, so a state without the chunk has all three
+    parameters.setSoundVersion(RenderParams::SOUND_VERSION_NOISE);
+    uint32_t tag = 0;
+    PluginState::Reader payload(nullptr, 0);
+    while (reader.nextChunk(tag, payload)) {
+        switch (tag) {
+            case PluginState::CHUNK_PARAMETERS:
+                parameters.readState(payload);
+                break;
+            case PluginState::CHUNK_PROGRAM: {
+                int program = int(payload.readI32());
+                // The user presets might not be open yet, then there's nothing to check against
+                if (program >= 0 && (program < getNumPrograms() || !userPresetsOpened.load())) {
+                    currentProgram = program;
+                }
+                break;
+            }
+            case PluginState::CHUNK_MIDI_LEARN: {
+                // Saved before the CC map, when only the resonance could be learned
+                ccMap.clear();
+                MidiCCMap::Mapping resonance;
+                resonance.parameter = parameters.indexOf(ParameterID::filterReso);
+                ccMap.set(payload.readU8(), resonance);
+                break;
+            }
+            case PluginState::CHUNK_CC_MAP:
+                readCCMap(payload);
+                break;
+            case PluginState::CHUNK_PARTS: {
+                uint32_t count = payload.readU32();
+                for (uint32_t i = 0; i < count && !payload.hasFailed(); ++i) {
+                    int program = int(payload.readI32());
+                    if (i + 1 < uint32_t(NUM_PARTS) && program >= 0 && program < Parameters::totalPresets()) {
+                        parts[i + 1].program.store(program);
+                    }
+                }
+                break;
+            }
+            case PluginState::CHUNK_SOUND_VERSION: {
+                int version = int(payload.readI32());
+                if (!payload.hasFailed() && version >= 0) {
+                    // From a newer version of the plugin, this is as close as it gets
+                    parameters.setSoundVersion(std::min(version, RenderParams::SOUND_VERSION));
+                }
+                break;
+            }
+            case PluginState::CHUNK_OPTIONS: {
+                uint32_t options = payload.readU32();
+                setFixedRenderRate((options & PluginState::OPTION_FIXED_RENDER_RATE) != 0);
+                setReleaseOnProgramChange((options & PluginState::OPTION_RELEASE_ON_PROGRAM_CHANGE) != 0);
+                setMultiTimbral((options & PluginState::OPTION_MULTI_TIMBRAL) != 0);
+                break;
+            }
+            default:
+                // From a newer version, skip it
+                break;
+        }
+    }
+    parametersChanged.store(true);
+}
+
+void JX11AudioProcessor::readCCMap(PluginState::Reader& reader) {
+    MidiCCMap::Mapping mappings[MidiCCMap::NUM_CCS];
+    uint32_t count = reader.readU32();
+    for (uint32_t i = 0; i < count && !reader.hasFailed(); ++i) {
+        MidiCCMap::Mapping mapping;
+        uint8_t cc = reader.readU8();
+        mapping.parameter = parameters.indexOfIDHash(reader.readU32());
+        mapping.rangeStart = juce::jlimit(0.0f, 1.0f, reader.readFloat());
+        mapping.rangeEnd = juce::jlimit(0.0f, 1.0f, reader.readFloat());
+        uint8_t curve = reader.readU8();
+        mapping.curve = curve < MidiCCMap::NUM_CURVES ? MidiCCMap::Curve(curve) : MidiCCMap::CURVE_LINEAR;
+        // A parameter this version doesn't have stays unmapped
+        if (!reader.hasFailed() && cc < MidiCCMap::NUM_CCS) {
+            mappings[cc] = mapping;
+        }
+    }
+    ccMap.setAll(mappings);
+}
+
+void JX11AudioProcessor::readLegacyState(const void* data, int sizeInBytes) {
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     if (xml.get() != nullptr && xml->hasTagName(pluginTag)) {
+        // The released versions that saved XML all had the original sound
+        parameters.setSoundVersion(RenderParams::SOUND_VERSION_ORIGINAL);
+        setFixedRenderRate(xml->getBoolAttribute("fixedRenderRate", false));
+        setReleaseOnProgramChange(xml->getBoolAttribute("releaseOnProgramChange", false));
         if (auto* parametersXML = xml->getChildByName(apvts.state.getType())) {
             apvts.replaceState(juce::ValueTree::fromXml(*parametersXML));
             parametersChanged.store(true);
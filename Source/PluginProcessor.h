@@ -10,12 +10,22 @@
 
 #include <JuceHeader.h>
 #include "Synth.h"
+#include "Parameters.h"
 #include "Preset.h"
+#include "Resampler.h"
+#include "UserPresetBank.h"
+#include "PresetPreviews.h"
+#include "PreviewPlayer.h"
+#include "MidiCCMap.h"
+#include "Telemetry.h"
+#include "AnalyserFifo.h"
+#include "PartRenderPool.h"
 
 //==============================================================================
 /**
 */
-class JX11AudioProcessor  : public juce::AudioProcessor, private juce::ValueTree::Listener
+class JX11AudioProcessor  : public juce::AudioProcessor, private juce::ValueTree::Listener, private juce::Timer,
+                            private juce::AudioProcessorParameter::Listener
 {
 public:
     //==============================================================================
@@ -58,22 +68,178 @@ public:
     void setStateInformation (const void* data, int sizeInBytes) override;
     // New stuff added by MYR
     juce::AudioProcessorValueTreeState apvts { *this, nullptr, "Parameters", createParameterLayout() };
+    // True while waiting for a CC to learn, the editor polls it
     std::atomic<bool> midiLearn;
+    // Learns the next CC for the parameter that was touched last (Filter Reso to begin with)
+    void startMidiLearn();
+    // The CC to parameter routing, message thread only (the audio thread has its own view)
+    MidiCCMap& getCCMap() noexcept { return ccMap; }
+    // Voices, levels and CPU load for the editor, see Telemetry.h.  One reader only
+    Telemetry& getTelemetry() noexcept { return telemetry; }
+    // The synth's output for the editor's scope and spectrum, see AnalyserFifo.h
+    AnalyserFifo& getAnalyserFifo() noexcept { return analyserFifo; }
+    // Render the synth at 44.1/48 kHz and upsample to the host rate in 88.2 kHz+ sessions.
+    // Changes the latency, so it only takes effect at the next prepareToPlay (see prepareAgain)
+    void setFixedRenderRate(bool shouldBeFixed);
+    bool isFixedRenderRate() const noexcept { return fixedRenderRate.load(); }
+    // What a program change (MIDI or from the host) does to the notes that are sounding:
+    // cut them off (the default), or let them finish with their release
+    void setReleaseOnProgramChange(bool shouldRelease);
+    bool isReleaseOnProgramChange() const noexcept { return releaseOnProgramChange.load(); }
+    // Multi-timbral: every MIDI channel plays its own part, with its own preset (chosen
+    // by a Program Change on that channel) and voices.  Channel 1 is the main synth and
+    // follows the knobs.  The parts render in parallel and always at the host rate.
+    // Only takes effect at the next prepareToPlay (see prepareAgain)
+    void setMultiTimbral(bool shouldBeMultiTimbral);
+    bool isMultiTimbral() const noexcept { return multiTimbral.load(); }
+    // Message thread.  Runs prepareToPlay again with the same settings, so the options
+    // above that wait for it take effect straight away.  Does nothing while the host
+    // has the resources released
+    void prepareAgain();
+    // The user preset library, message thread only.  User preset i is program
+    // Parameters::totalPresets() + i.  Opened the first time the preset browser asks for
+    // it, so an instance whose editor is never shown doesn't touch the file.  Until then
+    // the host only sees the factory presets, its program callbacks never open it
+    UserPresetBank& getUserPresets();
+    // Picks up presets saved or renamed by other instances.  Returns true if there were any
+    bool refreshUserPresets();
+    // Saves the current settings as a new user preset, returns its index in the bank (or -1)
+    int saveUserPreset(const juce::String& name, const juce::String& category);
+    // The preset previews, message thread only.  Created the first time they're needed
+    PresetPreviews& getPresetPreviews();
+    // Auditions a preview on top of whatever the synth is playing.  Returns false if the
+    // previous one hasn't started yet, try again a bit later
+    bool playPreview(PresetPreviews::Buffer preview);
+    void stopPreview();
 
 private:
     // New stuff added by MYR:
     Synth synth;
+    Parameters parameters;
     std::atomic<bool> parametersChanged { false };
+    // A MIDI volume change the host hasn't been told about yet (normalised, -1 means none).
+    // The audio thread sets it and the timer passes it on from the message thread
+    std::atomic<float> pendingOutputLevel { -1.0f };
+    // Same idea for a MIDI Program Change, the preset the host hasn't been told about yet
+    std::atomic<int> pendingProgram { -1 };
+    std::atomic<bool> releaseOnProgramChange { false };
+    // A program change from the host with releaseOnProgramChange on, for the audio thread
+    std::atomic<bool> pendingRelease { false };
+    // MIDI learn: the parameter being learned, and the CC the audio thread heard for it
+    // (-1 is none).  The timer adds the mapping
+    MidiCCMap ccMap;
+    std::atomic<int> learnParameter { -1 };
+    std::atomic<int> learnedCC { -1 };
+    // Message thread, from the parameters' gestures
+    int lastTouchedParameter = -1;
+    // Set while the timer passes MIDI changes on, so those don't count as touching a parameter
+    bool notifyingHost = false;
+    // Telemetry, gathered on the audio thread and sent about TELEMETRY_RATE times a second
+    static constexpr double TELEMETRY_RATE = 60.0;
+    Telemetry telemetry;
+    AnalyserFifo analyserFifo;
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+    TelemetryFrame telemetryFrame;
+    int telemetrySamples = 0;
+    int telemetryInterval = 735;
+    int telemetryLearnedCC = -1;
+    // The morph position glides to the parameter value, and while it's moving the synth
+    // gets a new snapshot every MORPH_STEP samples (at the host rate)
+    static constexpr int MORPH_STEP = 64;
+    static constexpr double MORPH_GLIDE_SECONDS = 0.05;
+    juce::LinearSmoothedValue<float> morphSmoother;
+    // Internal render rate
+    std::atomic<bool> fixedRenderRate { false };
+    double renderSampleRate = 44100.0;
+    int renderFactor = 1;
+    Upsampler upsamplers[2];
+    juce::AudioBuffer<float> internalBuffer;
+    juce::AudioBuffer<float> upsampledBuffer;
+    // Multi-timbral parts, one per MIDI channel.  Part 0 is the synth above, the others
+    // only exist while the mode is on.  The parts share VOICE_BUDGET voices
+    static constexpr int NUM_PARTS = 16;
+    static constexpr int VOICE_BUDGET = 32;
+    static constexpr int MAX_PART_EVENTS = 256;
+    struct PartEvent {
+        int position;
+        uint8_t data0, data1, data2;
+    };
+    struct Part {
+        Synth* synth = nullptr;
+        std::unique_ptr<Synth> ownSynth;
+        juce::AudioBuffer<float> buffer;
+        // This block's MIDI for the part, in order
+        std::array<PartEvent, MAX_PART_EVENTS> events;
+        int numEvents = 0;
+        int nextEvent = 0;
+        // The gain from a CC 7 on the part's channel (-1 is none, the preset's level)
+        float outputLevel = -1.0f;
+        // The preset it plays.  Set by the audio thread, read when saving the state
+        std::atomic<int> program { 0 };
+    };
+    std::atomic<bool> multiTimbral { false };
+    // Between prepareToPlay and releaseResources
+    std::atomic<bool> prepared { false };
+    // What prepareToPlay set up, the audio thread goes by this one
+    bool multiTimbralActive = false;
+    std::array<Part, NUM_PARTS> parts;
+    // The parts that have something to do this block
+    std::array<int, NUM_PARTS> partsToRender;
+    int partRenderCount = 0;
+    // The piece of the block being rendered (the parts' buffers only hold samplesPerBlock)
+    int partChunkStart = 0;
+    int partSampleCount = 0;
+    int partNumChannels = 2;
+    PartRenderPool partPool;
+    // Upsampled samples that didn't fit in the previous segment (always fewer than renderFactor)
+    float pendingSamples[2][Upsampler::MAX_FACTOR];
+    int pendingCount = 0;
+    int pendingOffset = 0;
     
     void splitBufferByEvents(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
     void handleMIDI(uint8_t data0, uint8_t data1, uint8_t data2);
     void render(juce::AudioBuffer<float>& buffer, int sampleCount, int bufferOffset);
+    void renderSegment(juce::AudioBuffer<float>& buffer, int sampleCount, int bufferOffset);
+    void renderUpsampled(float** outputBuffers, int sampleCount);
+    void prepareParts(int samplesPerBlock);
+    void processParts(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
+    // Gives every part but the first its preset's snapshot again
+    void updatePartParams();
+    static void renderPartJob(void* processor, int index);
+    void renderPart(int index);
+    // The processor's own MIDI handling (learn, mapped CCs, volume, Program Change).
+    // Returns false if it used the message up, otherwise it goes to the synth
+    bool handleControlMIDI(uint8_t data0, uint8_t data1, uint8_t data2);
+    // Gives the synth a fresh RenderParams snapshot
+    void updateRenderParams();
+    void writeState(PluginState::Writer& writer, const MidiCCMap::Mapping (&mappings)[MidiCCMap::NUM_CCS]) const;
+    void readBinaryState(const void* data, int sizeInBytes);
+    void readLegacyState(const void* data, int sizeInBytes);
+    void readCCMap(PluginState::Reader& reader);
+    // Program Change from the audio thread
+    void switchProgram(int index);
+    void timerCallback() override;
+    void parameterValueChanged(int, float) override {}
+    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override;
+    // Returns false if it's not a mapped CC (those are left to the synth)
+    bool handleMappedCC(uint8_t cc, uint8_t value);
+    void sendTelemetry(const juce::AudioBuffer<float>& buffer);
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     void valueTreePropertyChanged(juce::ValueTree&, const juce::Identifier&) override {
         //        DBG("Paameter changed!");
         parametersChanged.store(true);
     }
-    int currentProgram;
+    int currentProgram = 0;
+    // The host asks for program counts and names from any thread, those callbacks read
+    // the bank under its lock
+    UserPresetBank userPresets;
+    juce::CriticalSection userPresetLock;
+    std::atomic<bool> userPresetsOpened { false };
+    // A rename from the host, the timer does it (-1 is none).  Under userPresetLock
+    int pendingRenameIndex = -1;
+    juce::String pendingRenameName;
+    std::unique_ptr<PresetPreviews> presetPreviews;
+    PreviewPlayer previewPlayer;
     //
     // Keep this at the end
     //==============================================================================
@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+    PluginState.h
+    Created: 19 Oct 2026 9:47:03pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// The binary format for getStateInformation/setStateInformation.
+//
+//   header:  'JX11' magic, uint16 version, uint16 reserved
+//   chunks:  uint32 tag, uint32 payload size, payload
+//
+// Everything is little endian.  The reader skips chunks it doesn't know, so new
+// fields go in new chunks and older versions of the plugin can still load the state.
+namespace PluginState {
+
+    constexpr uint32_t makeTag(char a, char b, char c, char d) {
+        return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+    }
+
+    constexpr uint32_t MAGIC = makeTag('J', 'X', '1', '1');
+    constexpr uint16_t VERSION = 1;
+    constexpr int HEADER_SIZE = 8;
+
+    // uint32 count, then count x (uint32 parameter ID hash, float value)
+    constexpr uint32_t CHUNK_PARAMETERS = makeTag('P', 'A', 'R', 'M');
+    // int32 current program
+    constexpr uint32_t CHUNK_PROGRAM = makeTag('P', 'R', 'O', 'G');
+    // uint8 resonance CC.  Only read, from states saved before the CC map
+    constexpr uint32_t CHUNK_MIDI_LEARN = makeTag('M', 'I', 'D', 'I');
+    // uint32 count, then count x (uint8 CC, uint32 parameter ID hash, float range start,
+    // float range end, uint8 curve).  See MidiCCMap.h
+    constexpr uint32_t CHUNK_CC_MAP = makeTag('C', 'C', 'M', 'P');
+    // uint32 count, then count x int32 program, for the multi-timbral parts after the first
+    constexpr uint32_t CHUNK_PARTS = makeTag('P', 'A', 'R', 'T');
+    // int32 sound version, see RenderParams::SOUND_VERSION
+    constexpr uint32_t CHUNK_SOUND_VERSION = makeTag('S', 'N', 'D', 'V');
+    // uint32 flags, see below
+    constexpr uint32_t CHUNK_OPTIONS = makeTag('O', 'P', 'T', 'S');
+
+    constexpr uint32_t OPTION_FIXED_RENDER_RATE = 1 << 0;
+    constexpr uint32_t OPTION_RELEASE_ON_PROGRAM_CHANGE = 1 << 1;
+    constexpr uint32_t OPTION_MULTI_TIMBRAL = 1 << 2;
+
+    // 32-bit FNV-1a, for storing the parameter IDs as a number
+    constexpr uint32_t hashID(const char* s) {
+        uint32_t hash = 2166136261u;
+        while (*s != 0) {
+            hash ^= uint8_t(*s++);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    inline bool isLittleEndian() {
+        const uint16_t one = 1;
+        return *reinterpret_cast<const uint8_t*>(&one) == 1;
+    }
+
+    // Writes into a buffer it doesn't own.  With a null buffer it only counts the
+    // bytes, so the caller can size the buffer exactly and then write for real
+    class Writer {
+        public:
+            Writer(uint8_t* data_ = nullptr, size_t capacity_ = 0) : data(data_), capacity(capacity_) {}
+
+            void writeHeader() {
+                writeU32(MAGIC);
+                writeU16(VERSION);
+                writeU16(0);
+            }
+
+            // The size is filled in by endChunk
+            void beginChunk(uint32_t tag) {
+                writeU32(tag);
+                chunkStart = position;
+                writeU32(0);
+            }
+
+            void endChunk() {
+                uint32_t size = uint32_t(position - chunkStart - 4);
+                if (data != nullptr) {
+                    put(chunkStart, &size, 4);
+                }
+            }
+
+            void writeU8(uint8_t value) { write(&value, 1); }
+            void writeU16(uint16_t value) { write(&value, 2); }
+            void writeU32(uint32_t value) { write(&value, 4); }
+            void writeI32(int32_t value) { write(&value, 4); }
+            void writeFloat(float value) { write(&value, 4); }
+
+            size_t size() const noexcept { return position; }
+
+        private:
+            uint8_t* data;
+            size_t capacity;
+            size_t position = 0;
+            size_t chunkStart = 0;
+
+            void write(const void* value, size_t count) {
+                if (data != nullptr) {
+                    put(position, value, count);
+                }
+                position += count;
+            }
+
+            void put(size_t offset, const void* value, size_t count) {
+                if (offset + count > capacity) {
+                    return;
+                }
+                // Store little endian whatever the machine is
+                const uint8_t* bytes = static_cast<const uint8_t*>(value);
+                const bool littleEndian = isLittleEndian();
+                for (size_t i = 0; i < count; ++i) {
+                    data[offset + i] = littleEndian ? bytes[i] : bytes[count - 1 - i];
+                }
+            }
+    };
+
+    // Reads one pass through the data.  Reading past the end gives zeros and sets
+    // failed, so a truncated state can't read outside the buffer
+    class Reader {
+        public:
+            Reader(const void* data_, size_t size_) : data(static_cast<const uint8_t*>(data_)), size(size_) {}
+
+            static bool hasHeader(const void* data, size_t size) {
+                if (size < size_t(HEADER_SIZE)) {
+                    return false;
+                }
+                Reader reader(data, size);
+                return reader.readU32() == MAGIC;
+            }
+
+            // Returns the version, or 0 if this isn't our format
+            uint16_t readHeader() {
+                if (readU32() != MAGIC) {
+                    failed = true;
+                    return 0;
+                }
+                uint16_t version = readU16();
+                readU16();
+                return version;
+            }
+
+            // Moves to the next chunk.  payload only sees that chunk's bytes
+            bool nextChunk(uint32_t& tag, Reader& payload) {
+                if (failed || position + 8 > size) {
+                    return false;
+                }
+                tag = readU32();
+                uint32_t chunkSize = readU32();
+                if (chunkSize > size - position) {
+                    failed = true;
+                    return false;
+                }
+                payload = Reader(data + position, chunkSize);
+                position += chunkSize;
+                return true;
+            }
+
+            uint8_t readU8() { uint8_t value = 0; read(&value, 1); return value; }
+            uint16_t readU16() { uint16_t value = 0; read(&value, 2); return value; }
+            uint32_t readU32() { uint32_t value = 0; read(&value, 4); return value; }
+            int32_t readI32() { int32_t value = 0; read(&value, 4); return value; }
+            float readFloat() { float value = 0.0f; read(&value, 4); return value; }
+
+            bool hasFailed() const noexcept { return failed; }
+            size_t remaining() const noexcept { return size - position; }
+
+        private:
+            const uint8_t* data;
+            size_t size;
+            size_t position = 0;
+            bool failed = false;
+
+            void read(void* value, size_t count) {
+                if (position + count > size) {
+                    failed = true;
+                    position = size;
+                    return;
+                }
+                uint8_t* bytes = static_cast<uint8_t*>(value);
+                const bool littleEndian = isLittleEndian();
+                for (size_t i = 0; i < count; ++i) {
+                    bytes[littleEndian ? i : count - 1 - i] = data[position + i];
+                }
+                position += count;
+            }
+    };
+}
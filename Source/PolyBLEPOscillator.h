@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    PolyBLEPOscillator.h
+    Created: 19 Oct 2026 1:05:17pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// Sawtooth with a 2-sample polynomial band-limited step at the reset.  Same public
+// interface as the BLIT Oscillator, but it outputs the saw directly so the voice
+// doesn't need to integrate it.  Much cheaper than the BLIT (no sin/cos, no divide per
+// sample) at the cost of a little more aliasing near the top of the keyboard.
+class PolyBLEPOscillator {
+    public:
+        float period = 0.0f;
+        float amplitude = 1.0f;
+        float pitchModulation = 1.0f;
+    
+    void reset() {
+        // Starting at the end of a cycle makes the first sample pick up the period
+        phase = 1.0f;
+        inc = 0.0f;
+    }
+    
+    float nextSample() {
+        phase += inc;
+        if (phase >= 1.0f) {
+            // Like the BLIT, any change to the period is only picked up once per cycle
+            phase -= 1.0f;
+            inc = 1.0f / (period * pitchModulation);
+            if (phase >= 1.0f) {
+                phase = 0.0f;
+            }
+        }
+        // Ramps down from +0.5 to -0.5, so the step at the reset is +1 (same as the integrated BLIT)
+        float output = 0.5f - phase;
+        output += 0.5f * polyBLEP(phase, inc);
+        return amplitude * output;
+    }
+    
+    // Phase locks this oscillator half a cycle away from the other one (for PWM)
+    void squareWave(PolyBLEPOscillator& other, float newPeriod) {
+        if (other.inc > 0.0f) {
+            phase = other.phase + 0.5f;
+            if (phase >= 1.0f) {
+                phase -= 1.0f;
+            }
+            inc = other.inc;
+        } else {
+            // The other oscillator hasn't started yet
+            phase = 0.5f;
+            inc = 1.0f / newPeriod;
+        }
+    }
+    
+    private:
+        // Residual of a band limited unit step (the naive step is -2 to match the textbook saw)
+        static inline float polyBLEP(float t, float dt) {
+            if (t < dt) {
+                t /= dt;
+                return t + t - t * t - 1.0f;
+            } else if (t > 1.0f - dt) {
+                t = (t - 1.0f) / dt;
+                return t * t + t + t + 1.0f;
+            }
+            return 0.0f;
+        }
+    
+        float phase = 1.0f;
+        float inc = 0.0f;
+};
@@ -10,48 +10,100 @@
 
 #pragma once
 
-#include <cstring>
+const int NUM_PARAMS = 31;
 
-const int NUM_PARAMS = 26;
+// Where each parameter is in Preset::param.  RenderParams is derived from the values in this order
+enum PresetParam {
+    PARAM_OSC_MIX,
+    PARAM_OSC_TUNE,
+    PARAM_OSC_FINE,
+    PARAM_GLIDE_MODE,
+    PARAM_GLIDE_RATE,
+    PARAM_GLIDE_BEND,
+    PARAM_FILTER_FREQ,
+    PARAM_FILTER_RESO,
+    PARAM_FILTER_ENV,
+    PARAM_FILTER_LFO,
+    PARAM_FILTER_VELOCITY,
+    PARAM_FILTER_ATTACK,
+    PARAM_FILTER_DECAY,
+    PARAM_FILTER_SUSTAIN,
+    PARAM_FILTER_RELEASE,
+    PARAM_ENV_ATTACK,
+    PARAM_ENV_DECAY,
+    PARAM_ENV_SUSTAIN,
+    PARAM_ENV_RELEASE,
+    PARAM_LFO_RATE,
+    PARAM_VIBRATO,
+    PARAM_NOISE,
+    PARAM_OCTAVE,
+    PARAM_TUNING,
+    PARAM_OUTPUT_LEVEL,
+    PARAM_POLY_MODE,
+    PARAM_OSC_ENGINE,
+    PARAM_FILTER_TYPE,
+    PARAM_NOISE_TYPE,
+    PARAM_NOISE_SPREAD,
+    PARAM_LFO_WAVE
+};
+static_assert(PARAM_LFO_WAVE + 1 == NUM_PARAMS, "PresetParam and NUM_PARAMS are out of step");
+
+// The choices (and Octave, which only makes sense in whole octaves).  A morph between
+// two presets switches these over halfway instead of interpolating them
+constexpr bool isSwitchParam(int index) {
+    return index == PARAM_GLIDE_MODE || index == PARAM_OCTAVE || index == PARAM_POLY_MODE
+        || index == PARAM_OSC_ENGINE || index == PARAM_FILTER_TYPE || index == PARAM_NOISE_TYPE
+        || index == PARAM_NOISE_SPREAD || index == PARAM_LFO_WAVE;
+}
 
+// Plain data with a constexpr constructor, so the factory presets (FactoryPresets.h)
+// can live in read-only memory
 struct Preset {
-    Preset(const char* name,
+    constexpr Preset(const char* name_,
            float p0,  float p1,  float p2,  float p3,
            float p4,  float p5,  float p6,  float p7,
            float p8,  float p9,  float p10, float p11,
            float p12, float p13, float p14, float p15,
            float p16, float p17, float p18, float p19,
            float p20, float p21, float p22, float p23,
-           float p24, float p25) {
-        strcpy(this->name, name);
-        param[0] = p0; // Osc Mix
-        param[1] = p1; // Osc Tune
-        param[2] = p2; // Osc Fine
-        param[3] = p3; // Glide Mode
-        param[4] = p4; // Glide Rate
-        param[5] = p5; // Glide Bend
-        param[6] = p6; // Filter Freq
-        param[7] = p7; // Filter Reso
-        param[8] = p8; // Filter Env
-        param[9] = p9; // Filter LFO
-        param[10] = p10; // Velocity
-        param[11] = p11; // Filter Attack
-        param[12] = p12; // Filter Decay
-        param[13] = p13; // Filter Sustain
-        param[14] = p14; // Filter Release
-        param[15] = p15; // Env Attack
-        param[16] = p16; // Env Decay
-        param[17] = p17; // Env Sustain
-        param[18] = p18; // Env Release
-        param[19] = p19; // LFO Rate
-        param[20] = p20; // Vibrato
-        param[21] = p21; // Noise
-        param[22] = p22; // Octave
-        param[23] = p23; // Tuning
-        param[24] = p24; // Output Level
-        param[25] = p25; // Polyphony
-    }
+           float p24, float p25,
+           float p26 = 0.0f, float p27 = 0.0f, float p28 = 0.0f, float p29 = 0.0f,
+           float p30 = 0.0f)
+        : name(name_),
+          param {
+            p0,  // Osc Mix
+            p1,  // Osc Tune
+            p2,  // Osc Fine
+            p3,  // Glide Mode
+            p4,  // Glide Rate
+            p5,  // Glide Bend
+            p6,  // Filter Freq
+            p7,  // Filter Reso
+            p8,  // Filter Env
+            p9,  // Filter LFO
+            p10, // Velocity
+            p11, // Filter Attack
+            p12, // Filter Decay
+            p13, // Filter Sustain
+            p14, // Filter Release
+            p15, // Env Attack
+            p16, // Env Decay
+            p17, // Env Sustain
+            p18, // Env Release
+            p19, // LFO Rate
+            p20, // Vibrato
+            p21, // Noise
+            p22, // Octave
+            p23, // Tuning
+            p24, // Output Level
+            p25, // Polyphony
+            p26, // Osc Engine
+            p27, // Filter Type
+            p28, // Noise Type
+            p29, // Noise Spread
+            p30, // LFO Wave
+          } {}
     
-    char name[40];
+    const char* name;
     float param[NUM_PARAMS];
 };
@@ -0,0 +1,163 @@
+/*
+  ==============================================================================
+
+    PresetBrowser.cpp
+    Created: 19 Oct 2026 11:36:20pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include "PresetBrowser.h"
+
+PresetBrowser::PresetBrowser(JX11AudioProcessor& processor) : audioProcessor(processor) {
+    searchBox.setTextToShowWhenEmpty("Search", juce::Colour(120, 120, 120));
+    searchBox.onTextChange = [this] { refresh(); };
+    addAndMakeVisible(searchBox);
+
+    categoryBox.onChange = [this] { refresh(); };
+    addAndMakeVisible(categoryBox);
+
+    list.setModel(this);
+    list.setRowHeight(20);
+    addAndMakeVisible(list);
+
+    nameBox.setTextToShowWhenEmpty("Preset name", juce::Colour(120, 120, 120));
+    addAndMakeVisible(nameBox);
+    saveCategoryBox.setTextToShowWhenEmpty("Category", juce::Colour(120, 120, 120));
+    addAndMakeVisible(saveCategoryBox);
+    saveButton.setButtonText("Save");
+    saveButton.onClick = [this] { save(); };
+    addAndMakeVisible(saveButton);
+
+    updateCategories();
+    refresh();
+}
+
+PresetBrowser::~PresetBrowser() {
+    audioProcessor.stopPreview();
+}
+
+void PresetBrowser::resized() {
+    auto r = getLocalBounds();
+    auto top = r.removeFromTop(26);
+    categoryBox.setBounds(top.removeFromRight(140));
+    top.removeFromRight(6);
+    searchBox.setBounds(top);
+
+    auto bottom = r.removeFromBottom(26);
+    saveButton.setBounds(bottom.removeFromRight(70));
+    bottom.removeFromRight(6);
+    saveCategoryBox.setBounds(bottom.removeFromRight(140));
+    bottom.removeFromRight(6);
+    nameBox.setBounds(bottom);
+
+    r.reduce(0, 6);
+    list.setBounds(r);
+}
+
+void PresetBrowser::refresh() {
+    // Another instance might have saved a preset with a new category
+    if (audioProcessor.refreshUserPresets()) {
+        updateCategories();
+    }
+    // Item 1 is "All"
+    juce::String category = categoryBox.getSelectedId() > 1 ? categoryBox.getText() : juce::String();
+    results = audioProcessor.getUserPresets().search(searchBox.getText(), category);
+    list.updateContent();
+    list.repaint();
+
+    // Get the previews for the top of the list going, so they're ready when clicked
+    const auto& bank = audioProcessor.getUserPresets();
+    auto& previews = audioProcessor.getPresetPreviews();
+    for (int i = 0; i < juce::jmin(results.size(), PREFETCH_COUNT); ++i) {
+        previews.request(valuesOf(bank.record(results[i])));
+    }
+}
+
+PresetPreviews::Values PresetBrowser::valuesOf(const UserPresetBank::Record& record) {
+    PresetPreviews::Values values;
+    std::copy(record.param, record.param + NUM_PARAMS, values.begin());
+    return values;
+}
+
+void PresetBrowser::audition(int index) {
+    auditionValues = valuesOf(audioProcessor.getUserPresets().record(index));
+    auditionPending = !startAudition();
+    if (auditionPending) {
+        // Polls until the preview has been rendered
+        startTimerHz(20);
+    }
+}
+
+bool PresetBrowser::startAudition() {
+    auto preview = audioProcessor.getPresetPreviews().request(auditionValues);
+    return preview != nullptr && audioProcessor.playPreview(preview);
+}
+
+void PresetBrowser::timerCallback() {
+    if (!auditionPending || startAudition()) {
+        auditionPending = false;
+        stopTimer();
+    }
+}
+
+void PresetBrowser::updateCategories() {
+    juce::String selected = categoryBox.getText();
+    categoryBox.clear(juce::dontSendNotification);
+    categoryBox.addItem("All", 1);
+    categoryBox.addItemList(audioProcessor.getUserPresets().getCategories(), 2);
+    int id = 1;
+    for (int i = 0; i < categoryBox.getNumItems(); ++i) {
+        if (categoryBox.getItemText(i) == selected) {
+            id = categoryBox.getItemId(i);
+        }
+    }
+    categoryBox.setSelectedId(id, juce::dontSendNotification);
+}
+
+void PresetBrowser::save() {
+    juce::String name = nameBox.getText().trim();
+    if (name.isEmpty()) {
+        return;
+    }
+    if (audioProcessor.saveUserPreset(name, saveCategoryBox.getText().trim()) >= 0) {
+        nameBox.clear();
+        updateCategories();
+        refresh();
+    }
+}
+
+int PresetBrowser::getNumRows() {
+    return results.size();
+}
+
+void PresetBrowser::paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool rowIsSelected) {
+    const auto& bank = audioProcessor.getUserPresets();
+    if (row < 0 || row >= results.size() || results[row] >= bank.size()) {
+        return;
+    }
+    if (rowIsSelected) {
+        g.fillAll(findColour(juce::Slider::rotarySliderFillColourId).withAlpha(0.4f));
+    }
+    g.setColour(juce::Colours::white);
+    g.setFont(14.0f);
+    g.drawText(bank.getName(results[row]), 6, 0, width - 140, height, juce::Justification::centredLeft);
+    g.setColour(juce::Colour(180, 180, 180));
+    g.drawText(bank.getCategory(results[row]), width - 134, 0, 128, height, juce::Justification::centredRight);
+}
+
+void PresetBrowser::listBoxItemClicked(int row, const juce::MouseEvent&) {
+    if (row >= 0 && row < results.size()) {
+        audition(results[row]);
+    }
+}
+
+void PresetBrowser::listBoxItemDoubleClicked(int row, const juce::MouseEvent&) {
+    if (row >= 0 && row < results.size()) {
+        auditionPending = false;
+        stopTimer();
+        audioProcessor.stopPreview();
+        audioProcessor.setCurrentProgram(Parameters::totalPresets() + results[row]);
+    }
+}
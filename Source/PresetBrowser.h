@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    PresetBrowser.h
+    Created: 19 Oct 2026 11:36:20pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// Lists the user presets, with a search box and a category filter, and saves the
+// current sound as a new one.  The searching is done by UserPresetBank's index.
+// A click auditions the preset's preview, a double click loads it.
+class PresetBrowser : public juce::Component, private juce::ListBoxModel, private juce::Timer {
+    public:
+        explicit PresetBrowser(JX11AudioProcessor& processor);
+        ~PresetBrowser() override;
+        void resized() override;
+    private:
+        // How many previews a new search starts rendering
+        static constexpr int PREFETCH_COUNT = 16;
+
+        JX11AudioProcessor& audioProcessor;
+        juce::TextEditor searchBox;
+        juce::ComboBox categoryBox;
+        juce::ListBox list;
+        juce::TextEditor nameBox;
+        juce::TextEditor saveCategoryBox;
+        juce::TextButton saveButton;
+        // Indices into the bank of the presets in the list
+        juce::Array<int> results;
+        // The preset that was clicked, until its preview is ready and playing
+        bool auditionPending = false;
+        PresetPreviews::Values auditionValues {};
+
+        void refresh();
+        void updateCategories();
+        void save();
+        void audition(int index);
+        bool startAudition();
+        static PresetPreviews::Values valuesOf(const UserPresetBank::Record& record);
+        void timerCallback() override;
+        int getNumRows() override;
+        void paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+        void listBoxItemClicked(int row, const juce::MouseEvent&) override;
+        void listBoxItemDoubleClicked(int row, const juce::MouseEvent&) override;
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBrowser)
+};
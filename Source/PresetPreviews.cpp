@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    PresetPreviews.cpp
+    Created: 20 Oct 2026 12:14:51am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include "PresetPreviews.h"
+#include "Synth.h"
+#include "RenderParams.h"
+
+// A C major chord, low enough to hear the filter
+static const uint8_t PREVIEW_NOTES[] = { 48, 52, 55, 60 };
+static const uint8_t PREVIEW_VELOCITY = 100;
+
+PresetPreviews::PresetPreviews()
+    : pool(1, 0, juce::Thread::Priority::low) {
+    cacheFolder = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("JX11")
+        .getChildFile("Preview Cache");
+    cacheFolder.createDirectory();
+}
+
+PresetPreviews::~PresetPreviews() {
+    // The job that's running checks the flag, so this doesn't wait long.  It has to
+    // wait for it though, the job uses this object
+    stopping.store(true);
+    pool.removeAllJobs(true, -1);
+}
+
+PresetPreviews::Buffer PresetPreviews::request(const Values& values) {
+    const uint64_t hash = hashValues(values);
+    const juce::ScopedLock sl(lock);
+    auto found = previews.find(hash);
+    if (found != previews.end()) {
+        return found->second;
+    }
+    if (queued.count(hash) == 0 && int(queued.size()) < MAX_QUEUED) {
+        queued.insert(hash);
+        pool.addJob([this, hash, values] { renderJob(hash, values); });
+    }
+    return nullptr;
+}
+
+uint64_t PresetPreviews::hashValues(const Values& values) {
+    // 64-bit FNV-1a over the raw floats and the render version
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    add(&RENDER_VERSION, sizeof(RENDER_VERSION));
+    add(values.data(), sizeof(float) * values.size());
+    return hash;
+}
+
+// Worker thread
+void PresetPreviews::renderJob(uint64_t hash, Values values) {
+    if (stopping.load()) {
+        return;
+    }
+    Buffer preview = load(hash);
+    if (preview == nullptr) {
+        auto rendered = render(values);
+        if (rendered == nullptr) {
+            return;
+        }
+        save(hash, *rendered);
+        trimCache();
+        preview = rendered;
+    }
+    const juce::ScopedLock sl(lock);
+    previews[hash] = preview;
+    previewOrder.push_back(hash);
+    while (int(previewOrder.size()) > MAX_IN_MEMORY) {
+        previews.erase(previewOrder.front());
+        previewOrder.pop_front();
+    }
+    queued.erase(hash);
+    newPreviews.store(true);
+}
+
+// Runs the preset through a Synth of its own, mono, with the quality settings at their defaults
+PresetPreviews::Buffer PresetPreviews::render(const Values& values) const {
+    const int length = int(SAMPLE_RATE * LENGTH_SECONDS);
+    const int noteOffSample = int(SAMPLE_RATE * NOTE_SECONDS);
+    auto preview = std::make_shared<juce::AudioBuffer<float>>(1, length);
+
+    auto synth = std::make_unique<Synth>();
+    synth->allocateResources(SAMPLE_RATE, BLOCK_SIZE);
+    synth->setParams(RenderParams::derive(values.data(), float(SAMPLE_RATE)));
+    synth->reset();
+    for (uint8_t note : PREVIEW_NOTES) {
+        synth->midiMessage(0x90, note, PREVIEW_VELOCITY);
+    }
+    int position = 0;
+    while (position < length) {
+        if (stopping.load()) {
+            return nullptr;
+        }
+        // A block at a time, so a stop doesn't have to wait for the whole render
+        int end = std::min((position < noteOffSample) ? noteOffSample : length, position + BLOCK_SIZE);
+        float* outputBuffers[2] = { preview->getWritePointer(0) + position, nullptr };
+        synth->render(outputBuffers, end - position);
+        position = end;
+        if (position == noteOffSample) {
+            for (uint8_t note : PREVIEW_NOTES) {
+                synth->midiMessage(0x80, note, 0);
+            }
+        }
+    }
+    synth->deallocateResources();
+    return preview;
+}
+
+juce::File PresetPreviews::fileFor(uint64_t hash) const {
+    return cacheFolder.getChildFile(juce::String::toHexString(juce::int64(hash)).paddedLeft('0', 16) + ".flac");
+}
+
+PresetPreviews::Buffer PresetPreviews::load(uint64_t hash) const {
+    juce::File file = fileFor(hash);
+    if (!file.existsAsFile()) {
+        return nullptr;
+    }
+    juce::FlacAudioFormat flac;
+    std::unique_ptr<juce::AudioFormatReader> reader(flac.createReaderFor(new juce::FileInputStream(file), true));
+    if (reader == nullptr || reader->lengthInSamples <= 0) {
+        return nullptr;
+    }
+    auto preview = std::make_shared<juce::AudioBuffer<float>>(1, int(reader->lengthInSamples));
+    reader->read(preview.get(), 0, preview->getNumSamples(), 0, true, false);
+    // Counts as used, for trimCache
+    file.setLastModificationTime(juce::Time::getCurrentTime());
+    return preview;
+}
+
+// 16-bit mono FLAC, about 100 KB per preview
+void PresetPreviews::save(uint64_t hash, const juce::AudioBuffer<float>& preview) const {
+    juce::File file = fileFor(hash);
+    juce::File temp = file.getSiblingFile(file.getFileNameWithoutExtension() + ".tmp");
+    {
+        juce::FlacAudioFormat flac;
+        auto* stream = new juce::FileOutputStream(temp);
+        if (!stream->openedOk()) {
+            delete stream;
+            return;
+        }
+        std::unique_ptr<juce::AudioFormatWriter> writer(flac.createWriterFor(stream, SAMPLE_RATE, 1, 16, {}, 0));
+        if (writer == nullptr) {
+            delete stream;
+            return;
+        }
+        writer->writeFromAudioSampleBuffer(preview, 0, preview.getNumSamples());
+    }
+    // Only a complete file gets the real name, so a half written one is never loaded
+    temp.moveFileTo(file);
+}
+
+void PresetPreviews::trimCache() const {
+    juce::Array<juce::File> files = cacheFolder.findChildFiles(juce::File::findFiles, false, "*.flac");
+    if (files.size() <= MAX_ON_DISK) {
+        return;
+    }
+    // Oldest first
+    std::vector<std::pair<juce::Time, juce::File>> byAge;
+    for (const auto& file : files) {
+        byAge.emplace_back(file.getLastModificationTime(), file);
+    }
+    std::sort(byAge.begin(), byAge.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    for (size_t i = 0; i < byAge.size() - size_t(MAX_ON_DISK); ++i) {
+        byAge[i].second.deleteFile();
+    }
+}
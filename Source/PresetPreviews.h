@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    PresetPreviews.h
+    Created: 20 Oct 2026 12:14:51am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <deque>
+#include <map>
+#include <set>
+#include "Preset.h"
+
+// Renders a short phrase for each preset on low priority worker threads, with a
+// Synth of its own, so the browser can audition presets without a program change.
+// The previews are kept in memory and in a FLAC cache on disk.  The cache is keyed
+// by a hash of the preset's values, so an edited preset simply gets a new preview.
+// The disk cache keeps the MAX_ON_DISK most recently used previews.
+class PresetPreviews {
+    public:
+        using Buffer = std::shared_ptr<const juce::AudioBuffer<float>>;
+        using Values = std::array<float, NUM_PARAMS>;
+
+        static constexpr double SAMPLE_RATE = 44100.0;
+        static constexpr double LENGTH_SECONDS = 2.5;
+        // When the chord is let go, the rest is the release
+        static constexpr double NOTE_SECONDS = 1.5;
+
+        PresetPreviews();
+        ~PresetPreviews();
+
+        // Message thread.  Returns the preview if it's ready, otherwise starts loading or
+        // rendering it in the background and returns nullptr (ask again later)
+        Buffer request(const Values& values);
+        // True once since the last call if any preview finished in the background
+        bool takeNewPreviews() { return newPreviews.exchange(false); }
+
+        static uint64_t hashValues(const Values& values);
+
+    private:
+        // Mixed into the hash, bump it when the synth's sound changes
+        static constexpr uint32_t RENDER_VERSION = 1;
+        // Don't let a long search queue up thousands of renders
+        static constexpr int MAX_QUEUED = 64;
+        // About 440 KB each, the rest stay on disk
+        static constexpr int MAX_IN_MEMORY = 32;
+        // About 100 KB each, so the cache folder stays under 50 MB
+        static constexpr int MAX_ON_DISK = 500;
+
+        juce::ThreadPool pool;
+        juce::File cacheFolder;
+        juce::CriticalSection lock;
+        std::map<uint64_t, Buffer> previews;
+        // Oldest first, for dropping previews from memory
+        std::deque<uint64_t> previewOrder;
+        std::set<uint64_t> queued;
+        std::atomic<bool> newPreviews { false };
+        // Set by the destructor, a render that's running gives up
+        std::atomic<bool> stopping { false };
+
+        void renderJob(uint64_t hash, Values values);
+        // Returns nullptr if it was stopped
+        Buffer render(const Values& values) const;
+        juce::File fileFor(uint64_t hash) const;
+        Buffer load(uint64_t hash) const;
+        void save(uint64_t hash, const juce::AudioBuffer<float>& preview) const;
+        // Deletes the least recently used previews over MAX_ON_DISK
+        void trimCache() const;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetPreviews)
+};
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    PreviewPlayer.h
+    Created: 20 Oct 2026 12:14:51am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Plays a rendered preset preview on top of the synth.  The message thread hands
+// buffers over through two slots: it only ever writes the slot the audio thread
+// isn't reading, and the audio thread says which one it picked up, so there's no
+// lock and the audio thread never frees a buffer.
+class PreviewPlayer {
+    public:
+        using Buffer = std::shared_ptr<const juce::AudioBuffer<float>>;
+
+        // Message thread, before the audio starts
+        void prepare(double hostSampleRate) {
+            sampleRate = hostSampleRate;
+        }
+
+        // Message thread.  Returns false if the audio thread hasn't picked up the previous
+        // buffer yet, try again a bit later
+        bool play(Buffer buffer, double bufferSampleRate) {
+            if (lastPublished >= 0 && acknowledged.load() != lastPublished) {
+                return false;
+            }
+            int slot = (lastPublished >= 0) ? 1 - lastPublished : 0;
+            slots[slot].buffer = std::move(buffer);
+            slots[slot].sampleRate = bufferSampleRate;
+            lastPublished = slot;
+            requested.store(slot);
+            return true;
+        }
+
+        void stop() {
+            stopRequested.store(true);
+        }
+
+        // Audio thread, adds the preview into the output
+        void addTo(juce::AudioBuffer<float>& output) {
+            if (stopRequested.exchange(false)) {
+                current = -1;
+            }
+            int slot = requested.exchange(-1);
+            if (slot >= 0) {
+                current = slot;
+                position = 0.0;
+                acknowledged.store(slot);
+            }
+            if (current < 0) {
+                return;
+            }
+            const juce::AudioBuffer<float>& preview = *slots[current].buffer;
+            const float* source = preview.getReadPointer(0);
+            const int length = preview.getNumSamples();
+            // Linear interpolation is plenty for an audition
+            const double increment = slots[current].sampleRate / sampleRate;
+            for (int i = 0; i < output.getNumSamples(); ++i) {
+                int index = int(position);
+                if (index + 1 >= length) {
+                    current = -1;
+                    break;
+                }
+                float frac = float(position - double(index));
+                float value = source[index] + frac * (source[index + 1] - source[index]);
+                for (int ch = 0; ch < output.getNumChannels(); ++ch) {
+                    output.getWritePointer(ch)[i] += value;
+                }
+                position += increment;
+            }
+        }
+
+    private:
+        struct Slot {
+            Buffer buffer;
+            double sampleRate = 44100.0;
+        };
+        Slot slots[2];
+        std::atomic<int> requested { -1 };
+        std::atomic<int> acknowledged { -1 };
+        std::atomic<bool> stopRequested { false };
+        // Message thread
+        int lastPublished = -1;
+        // Audio thread
+        double sampleRate = 44100.0;
+        int current = -1;
+        double position = 0.0;
+};
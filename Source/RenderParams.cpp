@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    RenderParams.cpp
+    Created: 19 Oct 2026 8:14:55pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include <cmath>
+#include "RenderParams.h"
+
+void RenderParams::deriveRateDependent(RenderParams& p, const float* raw, float sampleRate) {
+    float inverseSampleRate = 1.0f / sampleRate;
+    const float inverseUpdateRate = inverseSampleRate * LFO_MAX;
+    float lfoRate = std::exp(7.0f * raw[PARAM_LFO_RATE] - 4.0f);
+    // In cycles per update
+    p.lfoInc = lfoRate * inverseUpdateRate;
+    // For the glide:
+    float glideRateTemp = raw[PARAM_GLIDE_RATE];
+    if (glideRateTemp < 2.0f) {
+        // No glide
+        p.glideRate = 1.0f;
+    } else {
+        p.glideRate = 1.0f - std::exp(-inverseUpdateRate * std::exp(6.0f - 0.07f * glideRateTemp));
+    }
+    // For the detune:
+    float semi = raw[PARAM_OSC_TUNE];
+    float cent = raw[PARAM_OSC_FINE];
+    // 1.05 = 2^(1/12), calculating the detune of the oscillator
+    // Use -semi because multiplication is cheaper than division
+    p.detune = std::pow(1.059463094359f, -semi - 0.01f * cent);
+
+    // Overall tuning:
+    float octave = raw[PARAM_OCTAVE];
+    float tuning = raw[PARAM_TUNING];
+    float tuneInSemi = -36.3763f - 12.0f * octave - tuning / 100.0f;
+    p.tune = sampleRate * std::exp(0.05776226505f * tuneInSemi);
+    // Update the envelope
+    float envOffset = 5.5f;
+    float envMult = 0.075f;
+    p.envAttack = std::exp(-inverseSampleRate * std::exp(envOffset - envMult * raw[PARAM_ENV_ATTACK]));
+    p.envDecay = std::exp(-inverseSampleRate * std::exp(envOffset - envMult * raw[PARAM_ENV_DECAY]));
+    float envReleaseTemp = raw[PARAM_ENV_RELEASE];
+    if (envReleaseTemp < 1.0f) {
+        p.envRelease = 0.75f;
+        p.originalEnvRelease = 0.75f;
+    } else {
+        p.envRelease = std::exp(-inverseSampleRate * std::exp(envOffset - envMult * envReleaseTemp));
+        // The original fed the previous multiplier back into the formula instead of the
+        // parameter, so every release above 0 settles on the same value.  It gets there
+        // within a couple of updates, and so does this
+        p.originalEnvRelease = 1.0f;
+        for (int i = 0; i < 3; ++i) {
+            p.originalEnvRelease = std::exp(-inverseSampleRate * std::exp(envOffset - envMult * p.originalEnvRelease));
+        }
+    }
+    p.outputLevel = std::pow(10.0f, raw[PARAM_OUTPUT_LEVEL] * 0.05f);
+    // Filter Stuff:
+    p.filterAttack = std::exp(-inverseUpdateRate * std::exp(envOffset - envMult * raw[PARAM_FILTER_ATTACK]));
+    p.filterDecay = std::exp(-inverseUpdateRate * std::exp(envOffset - envMult * raw[PARAM_FILTER_DECAY]));
+    p.filterRelease = std::exp(-inverseUpdateRate * std::exp(envOffset - envMult * raw[PARAM_FILTER_RELEASE]));
+    float filterReso = raw[PARAM_FILTER_RESO] / 100.0f;
+    p.filterQ = std::exp(3.0f * filterReso);
+}
+
+void RenderParams::applySoundVersion(RenderParams& p, int version) {
+    if (version < SOUND_VERSION_CONTROL_RATE) {
+        // One update does what LFO_MAX per-sample steps used to
+        const float steps = float(LFO_MAX);
+        p.lfoInc *= steps;
+        p.lfoInc -= std::floor(p.lfoInc);
+        p.glideRate = 1.0f - std::pow(1.0f - p.glideRate, steps);
+        p.filterAttack = std::pow(p.filterAttack, steps);
+        p.filterDecay = std::pow(p.filterDecay, steps);
+        p.filterRelease = std::pow(p.filterRelease, steps);
+        p.filterSmoothing = 1.0f - std::pow(1.0f - p.filterSmoothing, steps);
+    }
+    if (version < SOUND_VERSION_AMP_RELEASE) {
+        p.envRelease = p.originalEnvRelease;
+    }
+    p.originalNoise = version < SOUND_VERSION_NOISE;
+}
@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    RenderParams.h
+    Created: 19 Oct 2026 8:14:55pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <type_traits>
+#include "Constants.h"
+#include "Preset.h"
+
+// Everything the audio thread needs from the parameters, already converted into
+// the values the synth works with.  It's plain data (no JUCE types or pointers), so
+// a snapshot can be built once per block and the render code never has to touch
+// Parameters or the APVTS
+struct alignas(64) RenderParams {
+    // Oscillators
+    float oscMix = 0.0f;
+    float detune = 1.0f;
+    float tune = 0.0f;
+    int oscEngine = 0;
+    float volumeTrim = 0.0f;    // Used to automatically adjust the volume
+    float noiseMix = 0.0f;
+    int noiseType = 0;
+    int noiseSpread = 0;        // 0 = shared, 1 = per voice
+    bool originalNoise = false;         // For SOUND_VERSION_NOISE
+    // Amplitude envelope
+    float envAttack = 0.0f, envDecay = 0.0f, envSustain = 0.0f, envRelease = 0.0f;
+    float originalEnvRelease = 0.0f;    // For SOUND_VERSION_AMP_RELEASE
+    // Filter
+    float filterKeyTracking = 0.0f;
+    float filterQ = 1.0f;
+    float filterLFODepth = 0.0f;
+    float filterAttack = 0.0f, filterDecay = 0.0f, filterSustain = 0.0f, filterRelease = 0.0f;
+    float filterEnvDepth = 0.0f;
+    int filterType = 0;
+    float velocitySensitivity = 0.0f;
+    bool ignoreVelocity = false;
+    // Modulation
+    float lfoInc = 0.0f;        // In cycles per update
+    int lfoWave = 0;
+    float filterSmoothing = 0.005f;     // How far the filter modulation moves per update
+    float vibratoAmount = 0.0f;
+    float pwmDepth = 0.0f;
+    // Overall
+    int glideMode = 0;
+    float glideRate = 1.0f;
+    float glideBend = 0.0f;
+    int numVoices = MAX_VOICES;
+    float outputLevel = 1.0f;   // Gain, not dB
+    // Quality settings, these aren't part of the presets
+    int filterOversampling = 1;     // 1, 2 or 4
+    int filterCoefficients = 0;     // 0 = exact, 1 = table
+
+    static constexpr float ANALOG = 0.002f;
+
+    // Sessions keep the sound they were saved with.  When a fix changes how existing
+    // patches sound, it gets a new version here and applySoundVersion keeps the old
+    // behaviour for the sessions from before it
+    //   0: the original, the modulation (LFO, glide, filter envelope) stepped every
+    //      sample, LFO_MAX times faster than the parameters say
+    //   1: the modulation steps every LFO_MAX samples and matches the parameters
+    //   2: the amp release follows the Release parameter (before, every release above 0
+    //      was the same short one)
+    //   3: the white noise comes from the block generator (before, one LCG step per
+    //      sample, so the same settings give a different noise sequence)
+    static constexpr int SOUND_VERSION_ORIGINAL = 0;
+    static constexpr int SOUND_VERSION_CONTROL_RATE = 1;
+    static constexpr int SOUND_VERSION_AMP_RELEASE = 2;
+    static constexpr int SOUND_VERSION_NOISE = 3;
+    static constexpr int SOUND_VERSION = SOUND_VERSION_NOISE;
+
+    // raw holds the parameter values in Preset order (what AudioParameter::get returns,
+    // or the index for the choices).  Doesn't read anything else, so it's safe to call
+    // from any thread
+    static RenderParams derive(const float* raw, float sampleRate) {
+        RenderParams p = deriveRateIndependent(raw);
+        deriveRateDependent(p, raw, sampleRate);
+        return p;
+    }
+
+    // The values that are just arithmetic on the parameters.  constexpr, so the factory
+    // presets get these worked out by the compiler (see FactoryPresets.h)
+    static constexpr RenderParams deriveRateIndependent(const float* raw) {
+        RenderParams p;
+        float vibratoTemp = raw[PARAM_VIBRATO] / 200.0f;
+        p.vibratoAmount = 0.2f * vibratoTemp * vibratoTemp;
+        p.pwmDepth = p.vibratoAmount;
+        // If the vibrato parameter < 0, then it is used for PWM
+        if (vibratoTemp < 0.0f) {
+            p.vibratoAmount = 0.0f;
+        }
+        p.lfoWave = int(raw[PARAM_LFO_WAVE]);
+        p.glideMode = int(raw[PARAM_GLIDE_MODE]);
+        p.glideBend = raw[PARAM_GLIDE_BEND];
+        p.numVoices = (int(raw[PARAM_POLY_MODE]) == 0) ? 1 : MAX_VOICES;
+        p.oscEngine = int(raw[PARAM_OSC_ENGINE]);
+        p.filterType = int(raw[PARAM_FILTER_TYPE]);
+        p.noiseType = int(raw[PARAM_NOISE_TYPE]);
+        p.noiseSpread = int(raw[PARAM_NOISE_SPREAD]);
+        float filterVelocity = raw[PARAM_FILTER_VELOCITY];
+        if (filterVelocity < -90.0f) {
+            p.velocitySensitivity = 0.0f;
+            p.ignoreVelocity = true;
+        } else {
+            p.velocitySensitivity = 0.0005f * filterVelocity;
+            p.ignoreVelocity = false;
+        }
+        p.envSustain = raw[PARAM_ENV_SUSTAIN] / 100.0f;
+        // Update the noise value we have
+        float noiseMixTemp = raw[PARAM_NOISE] / 100.0f;
+        noiseMixTemp *= noiseMixTemp;
+        p.noiseMix = noiseMixTemp * 0.06f;
+        p.oscMix = raw[PARAM_OSC_MIX] / 100.0f;
+        p.filterKeyTracking = 0.08f * raw[PARAM_FILTER_FREQ] - 1.5f;
+        float filterSus = raw[PARAM_FILTER_SUSTAIN] / 100.0f;
+        p.filterSustain = filterSus * filterSus;
+        p.filterEnvDepth = 0.06f * raw[PARAM_FILTER_ENV];
+        float filterLFO = raw[PARAM_FILTER_LFO] / 100.0f;
+        p.filterLFODepth = 2.5f * filterLFO * filterLFO;
+        float filterReso = raw[PARAM_FILTER_RESO] / 100.0f;
+        // Automatically adjust the volume (not sure what the magic numbers are for)
+        p.volumeTrim = 0.0008f * (3.2f - p.oscMix - 25.0f * p.noiseMix) * (1.5f - 0.5f  * filterReso);
+        return p;
+    }
+
+    // The rest needs exp and pow, and most of it depends on the sample rate
+    static void deriveRateDependent(RenderParams& p, const float* raw, float sampleRate);
+
+    // Changes a snapshot to sound like an older version (see SOUND_VERSION)
+    static void applySoundVersion(RenderParams& p, int version);
+};
+
+static_assert(std::is_trivially_copyable<RenderParams>::value, "RenderParams gets copied around by value");
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    Resampler.h
+    Created: 19 Oct 2026 10:12:40am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "Constants.h"
+
+// Polyphase interpolator used when the synth renders at a fixed internal rate.
+// The internal rate is always the host rate divided by a whole number (1, 2 or 4),
+// so every input sample produces exactly `factor` output samples and each output
+// sample is one short dot product (TAPS_PER_PHASE multiplies).
+class Upsampler {
+    public:
+        static constexpr int TAPS_PER_PHASE = 32;
+        static constexpr int MAX_FACTOR = 4;
+
+        // Keeps the internal rate at 44.1 or 48 kHz for 88.2/96/176.4/192 kHz sessions
+        static int factorForRate(double hostRate) {
+            if (hostRate >= 176400.0) {
+                return 4;
+            } else if (hostRate >= 88200.0) {
+                return 2;
+            }
+            return 1;
+        }
+
+        // Not real-time safe: builds the filter, call from prepareToPlay
+        void prepare(int newFactor) {
+            factor = std::clamp(newFactor, 1, MAX_FACTOR);
+            // One tap short of filling every phase, so the length is odd and the group
+            // delay is a whole number of output samples (the last tap stays zero)
+            const int length = factor * TAPS_PER_PHASE - 1;
+            // Prototype lowpass, normalised to the output rate. The cutoff sits a bit below
+            // the internal Nyquist so the Kaiser transition band ends before the first image.
+            const double cutoff = 0.45 / double(factor);
+            const double centre = 0.5 * double(length - 1);
+            const double beta = 8.0;    // about -80dB stopband
+            const double norm = besselI0(beta);
+
+            std::vector<double> prototype(size_t(length), 0.0);
+            for (int n = 0; n < length; ++n) {
+                double x = double(n) - centre;
+                double sinc = (x == 0.0) ? 1.0 : std::sin(double(TWO_PI) * cutoff * x) / (double(PI) * x * 2.0 * cutoff);
+                double r = x / centre;
+                double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+                // Multiply by the factor to make up for the zeros that are stuffed between samples
+                prototype[size_t(n)] = 2.0 * cutoff * sinc * window * double(factor);
+            }
+
+            // Split into phases.  Phase p uses every factor-th tap, starting at p.  The phases
+            // are interleaved per tap so one history sample feeds all outputs with a single
+            // 4-wide multiply-add; unused phases stay zero when the factor is below 4
+            coeffs.assign(size_t(MAX_FACTOR * TAPS_PER_PHASE), 0.0f);
+            for (int p = 0; p < factor; ++p) {
+                for (int k = 0; k < TAPS_PER_PHASE && p + k * factor < length; ++k) {
+                    coeffs[size_t(k * MAX_FACTOR + p)] = float(prototype[size_t(p + k * factor)]);
+                }
+            }
+            reset();
+        }
+
+        void reset() {
+            std::fill(history, history + 2 * TAPS_PER_PHASE, 0.0f);
+            pos = 0;
+        }
+
+        int getFactor() const noexcept {
+            return factor;
+        }
+
+        // Group delay of the linear phase filter, in output (host) samples.  It's the
+        // prototype's centre tap, (length - 1) / 2
+        int getLatency() const noexcept {
+            return factor == 1 ? 0 : (factor * TAPS_PER_PHASE) / 2 - 1;
+        }
+
+        // Writes inputCount * factor samples to output
+        void process(const float* input, float* output, int inputCount) noexcept {
+            const float* h = coeffs.data();
+            for (int i = 0; i < inputCount; ++i) {
+                // The history is stored twice so the newest TAPS_PER_PHASE samples are always contiguous
+                pos = (pos == 0) ? TAPS_PER_PHASE - 1 : pos - 1;
+                history[pos] = input[i];
+                history[pos + TAPS_PER_PHASE] = input[i];
+                const float* x = history + pos;
+
+                // Two sets of sums, for the even and the odd taps, so each add doesn't have
+                // to wait for the one before it to finish.  About twice as fast
+                float even[MAX_FACTOR] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                float odd[MAX_FACTOR] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                for (int k = 0; k < TAPS_PER_PHASE; k += 2) {
+                    const float* hk = h + k * MAX_FACTOR;
+                    for (int p = 0; p < MAX_FACTOR; ++p) {
+                        even[p] += hk[p] * x[k];
+                        odd[p] += hk[p + MAX_FACTOR] * x[k + 1];
+                    }
+                }
+                for (int p = 0; p < factor; ++p) {
+                    *output++ = even[p] + odd[p];
+                }
+            }
+        }
+
+    private:
+        static double besselI0(double x) {
+            double sum = 1.0;
+            double term = 1.0;
+            for (int k = 1; k < 32; ++k) {
+                double t = x / (2.0 * double(k));
+                term *= t * t;
+                sum += term;
+            }
+            return sum;
+        }
+
+        int factor = 1;
+        int pos = 0;
+        std::vector<float> coeffs;
+        float history[2 * TAPS_PER_PHASE] = {};
+};
@@ -20,6 +20,8 @@ RotaryKnob::RotaryKnob() {
     slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, textBoxWidth, textBoxHeight);
     // Adjust the start and end radians
     slider.setRotaryParameters(juce::degreesToRadians(225.0f), juce::degreesToRadians(495.0f), true);
+    // The LookAndFeel fills in the background, so turning the knob only repaints the slider
+    slider.setOpaque(true);
     
     addAndMakeVisible(slider);
     setBounds(0, 0, textBoxWidth, textBoxHeight + knobDim);
@@ -31,8 +33,9 @@ RotaryKnob::~RotaryKnob() {
 
 void RotaryKnob::resized() {
     auto bounds = getLocalBounds();
-    // Make room for the label on top, hence why we are subtracting
-    slider.setBounds(0, labelHeight, bounds.getWidth(), bounds.getHeight() - labelHeight);
+    // Make room for the label on top, hence why we are subtracting.  The slider is opaque,
+    // so keep it inside the outline
+    slider.setBounds(1, labelHeight, bounds.getWidth() - 2, bounds.getHeight() - labelHeight - 1);
 }
 
 void RotaryKnob::paint(juce::Graphics & g) {
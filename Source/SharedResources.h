@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    SharedResources.h
+    Created: 19 Oct 2026 10:21:36pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Read-only tables that every plugin instance in the process can share.  There's
+// one registry per table type, keyed by sample rate (0 for the tables that don't
+// depend on it).  The registry only keeps weak references, so a table is freed
+// when the last instance using it lets go.
+//
+// Not real-time safe (it locks and may build the table), call it from
+// allocateResources.  The table itself is never written after it's built, so the
+// audio threads can read it without any locking.
+template<typename Table>
+class SharedResources {
+    public:
+        // build is only called when no instance has a table for this key yet
+        template<typename Builder>
+        static std::shared_ptr<const Table> get(double sampleRate, Builder build) {
+            std::lock_guard<std::mutex> guard(registry().lock);
+            auto& tables = registry().tables;
+            auto& slot = tables[sampleRate];
+            if (auto table = slot.lock()) {
+                return table;
+            }
+            auto table = std::make_shared<Table>();
+            build(*table);
+            slot = table;
+            // Forget the tables nobody uses anymore
+            for (auto it = tables.begin(); it != tables.end();) {
+                it = it->second.expired() ? tables.erase(it) : std::next(it);
+            }
+            return table;
+        }
+
+        // How many different tables are alive right now
+        static int liveCount() {
+            std::lock_guard<std::mutex> guard(registry().lock);
+            int count = 0;
+            for (const auto& entry : registry().tables) {
+                count += entry.second.expired() ? 0 : 1;
+            }
+            return count;
+        }
+
+    private:
+        struct Registry {
+            std::mutex lock;
+            std::map<double, std::weak_ptr<const Table>> tables;
+        };
+
+        static Registry& registry() {
+            static Registry instance;
+            return instance;
+        }
+};
@@ -17,8 +17,19 @@ Synth::Synth() {
 
 void Synth::allocateResources(double sampleRate_, int /*samplesPerBlock*/) {
     sampleRate = static_cast<float>(sampleRate_);
+    // Only built by the first instance, the tables don't depend on the sample rate
+    wavetables = SharedResources<WavetableBank>::get(0.0, [](WavetableBank& bank) { bank.build(); });
+    // Shared by all instances, this only builds it the first time
+    SincTable::get();
+    voiceSettings.log2SampleRate = std::log2(sampleRate);
+    // One per sample rate in use
+    filterTable = SharedResources<FilterCoefficientTable>::get(sampleRate_, [this](FilterCoefficientTable& table) {
+        table.build(sampleRate);
+    });
     for (int v = 0; v < MAX_VOICES; ++v) {
         voices[v].filter.sampleRate = sampleRate;
+        voices[v].ladder.sampleRate = sampleRate;
+        voices[v].setWavetables(wavetables.get());
     }
 }
 
@@ -29,59 +40,119 @@ void Synth::deallocateResources() {
 void Synth::reset() {
     for (int v = 0; v < MAX_VOICES; v++) {
         voices[v].reset();
+        // Each voice gets its own stream for the Per Voice noise
+        voices[v].noiseGen.reset(22222u + 7919u * unsigned(v + 1));
     }
     noiseGen.reset();
     sustainPedalPressed = false;
-    params.reset(sampleRate);
-    lfo = 0.0f;
+    // Assume the pitch wheel is in the center position when starting, and the mod wheel is all the way down
+    pitchBend = 1.0f;
+    modWheel = 0.0f;
+    outputLevelSmoother.reset(sampleRate, 0.05);
+    outputLevelSmoother.setCurrentAndTargetValue(params.outputLevel);
+    lfo.reset();
     lfoStep = 0;
     lastNote = 0;
     aftertouch = 0.0f;
-    resonanceCtrl = 1.0f;
     filterCtrl = 0.0f;
 }
 
+void Synth::setParams(const RenderParams& newParams) {
+    params = newParams;
+    outputLevelSmoother.setTargetValue(params.outputLevel);
+}
+
+void Synth::setOutputLevel(float gain) {
+    outputLevelSmoother.setTargetValue(gain);
+}
+
+int Synth::getVoiceStates(uint8_t* notes, float* envelopeLevels) const {
+    int activeVoices = 0;
+    for (int v = 0; v < MAX_VOICES; ++v) {
+        const Voice& voice = voices[v];
+        const bool active = voice.env.isActive();
+        notes[v] = active ? uint8_t(voice.note) : 0;
+        envelopeLevels[v] = active ? voice.env.level : 0.0f;
+        activeVoices += active ? 1 : 0;
+    }
+    return activeVoices;
+}
+
+int Synth::getActiveVoiceCount() const {
+    int activeVoices = 0;
+    for (int v = 0; v < MAX_VOICES; ++v) {
+        activeVoices += voices[v].env.isActive() ? 1 : 0;
+    }
+    return activeVoices;
+}
+
+void Synth::releaseAllVoices() {
+    for (int v = 0; v < MAX_VOICES; ++v) {
+        if (voices[v].note != 0) {
+            voices[v].release();
+            voices[v].note = 0;
+        }
+    }
+    sustainPedalPressed = false;
+}
+
 void Synth::render(float **outputBuffers, int sampleCount) {
     // Renders a naked float pointer
     // We could use a juce::AudioBuffer if we wanted to
     float* outputBufferLeft = outputBuffers[0];
     float* outputBufferRight = outputBuffers[1];
+    
+    // The settings every voice shares, once per block instead of once per voice per update
+    voiceSettings.oscEngine = params.oscEngine;
+    voiceSettings.filterType = params.filterType;
+    voiceSettings.maxOversampling = params.filterOversampling;
+    voiceSettings.glideRate = params.glideRate;
+    voiceSettings.filterQ = params.filterQ;
+    voiceSettings.pitchBend = pitchBend;
+    voiceSettings.filterEnvDepth = params.filterEnvDepth;
+    voiceSettings.coefficientTable = params.filterCoefficients == 1 ? filterTable.get() : nullptr;
+    voiceSettings.log2FilterQ = std::log2(voiceSettings.filterQ);
+    voiceSettings.filterK = 1.0f / voiceSettings.filterQ;
+    voiceSettings.log2PitchBend = std::log2(pitchBend);
+    lfo.waveform = params.lfoWave;
+    lfo.inc = params.lfoInc;
         
     for (int v = 0; v < MAX_VOICES; ++v) {
         Voice& voice = voices[v];
         if (voice.env.isActive()) {
             updatePeriod(voice);
-            voice.glideRate = params.glideRate;
-            voice.filterQ = params.filterQ * resonanceCtrl;
-            voice.pitchBend = params.pitchBend;
-            voice.filterEnvDepth = params.filterEnvDepth;
         }
     }
     
-    for (int sample = 0; sample < sampleCount; ++sample) {
-        updateLFO();
-        const float noise = noiseGen.nextValue() * params.noiseMix;
-
-        float outputLeft = 0.0f;
-        float outputRight = 0.0f;
+    // The modulation (LFO, filter envelope, glide) is updated every LFO_MAX samples. Up to
+    // MAX_UPDATES of those updates are computed ahead into buffers, then the voices render
+    // in chunks that end where the next update is due
+    int offset = 0;
+    while (offset < sampleCount) {
+        // lfoStep is how many samples until the next update
+        const int segmentSize = std::min(sampleCount - offset, lfoStep + MAX_UPDATES * LFO_MAX);
+        const int updateCount = segmentSize > lfoStep ? (segmentSize - lfoStep - 1) / LFO_MAX + 1 : 0;
+        lfo.renderBlock(lfoBlock, updateCount);
         for (int v = 0; v < MAX_VOICES; ++v) {
             Voice& voice = voices[v];
             if (voice.env.isActive()) {
-                float output = voice.render(noise);
-                outputLeft += output * voice.panLeft;
-                outputRight += output * voice.panRight;
+                voice.filterEnv.renderBlock(voice.filterEnvBlock, updateCount);
             }
         }
-        // Adjust the gain
-        float outputLevel = params.outputLevelSmoother.getNextValue();
-        outputLeft *= outputLevel;
-        outputRight *= outputLevel;
-            
-        if (outputBufferRight != nullptr) {
-            outputBufferLeft[sample] = outputLeft;
-            outputBufferRight[sample] = outputRight;
-        } else {
-            outputBufferLeft[sample] = (outputLeft + outputRight) * 0.5f;
+        
+        int update = 0;
+        const int segmentEnd = offset + segmentSize;
+        while (offset < segmentEnd) {
+            if (lfoStep == 0) {
+                lfoStep = LFO_MAX;
+                updateLFO(update++);
+            }
+            const int blockSize = std::min(lfoStep, segmentEnd - offset);
+            lfoStep -= blockSize;
+            renderVoices(outputBufferLeft + offset,
+                         outputBufferRight != nullptr ? outputBufferRight + offset : nullptr,
+                         blockSize);
+            offset += blockSize;
         }
     }
     // Turn off the synth (don't render) if the envelope dips down
@@ -97,27 +168,69 @@ void Synth::render(float **outputBuffers, int sampleCount) {
     protectYourEars(outputBufferRight, sampleCount);
 }
 
-void Synth::updateLFO() {
-    if (--lfoStep <= 0) {
-        lfoStep = LFO_MAX;
+void Synth::renderVoices(float* outputBufferLeft, float* outputBufferRight, int blockSize) {
+    const bool perVoiceNoise = params.noiseSpread == 1;
+    if (!perVoiceNoise) {
+        noiseGen.fillBlock(noiseBlock, blockSize, params.noiseType, params.originalNoise);
+        scaleNoise(noiseBlock, blockSize);
     }
-    lfo += params.lfoInc;
-    if (lfo > PI) {
-        lfo -= TWO_PI;
+    for (int v = 0; v < MAX_VOICES; ++v) {
+        Voice& voice = voices[v];
+        voice.active = voice.env.isActive();
+        if (voice.active) {
+            voice.renderEnvelope(blockSize);
+            if (perVoiceNoise) {
+                voice.noiseGen.fillBlock(voice.noiseBlock, blockSize, params.noiseType, params.originalNoise);
+                scaleNoise(voice.noiseBlock, blockSize);
+            }
+        }
     }
-    const float sine = std::sin(lfo);
-    float vibratoMod = 1.0f + sine * (params.modWheel + params.vibratoAmount);
-    float pwm = 1.0f + sine * (params.modWheel + params.pwmDepth);
-    float filterMod = params.filterKeyTracking + filterCtrl + (params.filterLFODepth + aftertouch) * sine;
-    filterZip += .005f * (filterMod - filterZip);
+    
+    for (int i = 0; i < blockSize; ++i) {
+        float outputLeft = 0.0f;
+        float outputRight = 0.0f;
+        for (int v = 0; v < MAX_VOICES; ++v) {
+            Voice& voice = voices[v];
+            if (voice.active) {
+                const float noise = perVoiceNoise ? voice.noiseBlock[i] : noiseBlock[i];
+                float output = voice.render(voiceSettings, noise, i);
+                outputLeft += output * voice.panLeft;
+                outputRight += output * voice.panRight;
+            }
+        }
+        // Adjust the gain
+        float outputLevel = outputLevelSmoother.getNextValue();
+        outputLeft *= outputLevel;
+        outputRight *= outputLevel;
+        
+        if (outputBufferRight != nullptr) {
+            outputBufferLeft[i] = outputLeft;
+            outputBufferRight[i] = outputRight;
+        } else {
+            outputBufferLeft[i] = (outputLeft + outputRight) * 0.5f;
+        }
+    }
+}
+
+void Synth::scaleNoise(float* buffer, int sampleCount) const {
+    for (int i = 0; i < sampleCount; ++i) {
+        buffer[i] *= params.noiseMix;
+    }
+}
+
+void Synth::updateLFO(int update) {
+    const float lfoValue = lfoBlock[update];
+    float vibratoMod = 1.0f + lfoValue * (modWheel + params.vibratoAmount);
+    float pwm = 1.0f + lfoValue * (modWheel + params.pwmDepth);
+    float filterMod = params.filterKeyTracking + filterCtrl + (params.filterLFODepth + aftertouch) * lfoValue;
+    filterZip += params.filterSmoothing * (filterMod - filterZip);
+    voiceSettings.filterMod = filterZip;
     
     for (int v = 0; v < MAX_VOICES; ++v) {
         Voice& voice = voices[v];
         if (voice.env.isActive()) {
-            voice.osc1.pitchModulation = vibratoMod;
-            voice.osc2.pitchModulation = pwm;
-            voice.filterMod = filterZip;
-            voice.updateLFO();
+            voice.setPitchModulation(vibratoMod, pwm);
+            voice.updateLFO(voiceSettings, update);
             updatePeriod(voice);
         }
     }
@@ -127,7 +240,7 @@ void Synth::midiMessage(uint8_t data0, uint8_t data1, uint8_t data2) {
     switch (data0 & 0xF0) {
         // Pitch Bend
         case 0xE0:
-            params.pitchBend = std::exp(-0.000014102f * float(data1 + 128 * data2 - 8192));
+            pitchBend = std::exp(-0.000014102f * float(data1 + 128 * data2 - 8192));
             break;
         // Control Change
         case 0xB0:
@@ -180,11 +293,11 @@ void Synth::startNote(int v, int note, int velocity) {
     // Old way:
 //    voice.osc1.amplitude = (params.volumeTrim * velocity / 127.0f) * 0.5f;
     float vel = 0.004f * ((velocity + 64) * (velocity + 64)) - 8.0f;
-    voice.osc1.amplitude = params.volumeTrim * vel;
-    voice.osc2.amplitude = voice.osc1.amplitude * params.oscMix;
+    float amplitude = params.volumeTrim * vel;
+    voice.setAmplitudes(amplitude, amplitude * params.oscMix);
     // If in PWM mode, phase lock oscillator 2
     if (params.vibratoAmount == 0.0f && params.pwmDepth > 0.0f) {
-        voice.osc2.squareWave(voice.osc1, voice.period);
+        voice.squareWave(voice.period);
     }
     // Amp Enveloep
     voice.env.attackMultiplier = params.envAttack;
@@ -199,8 +312,7 @@ void Synth::startNote(int v, int note, int velocity) {
     voice.filterEnv.releaseMultiplier = params.filterRelease;
     voice.filterEnv.attack();
     
-    voice.cutoff = sampleRate / period;
-    voice.cutoff *= std::exp(params.velocitySensitivity * float(velocity - 64));
+    voice.setCutoff(sampleRate / period * std::exp(params.velocitySensitivity * float(velocity - 64)));
 }
 
 void Synth::noteOn(int note, int velocity) {
@@ -250,10 +362,11 @@ void Synth::restartMonoVoice(int note, int velocity) {
     if (params.glideMode == 0) {
         voice.period = period;
     }
-    voice.cutoff = sampleRate / (period * PI);
+    float cutoff = sampleRate / (period * PI);
     if (velocity > 0) {
-        voice.cutoff *= std::exp(params.velocitySensitivity * float(velocity - 64));
+        cutoff *= std::exp(params.velocitySensitivity * float(velocity - 64));
     }
+    voice.setCutoff(cutoff);
     voice.env.level = SILENCE + SILENCE;
     voice.note = note;
     voice.updatePanning();
@@ -263,7 +376,7 @@ void Synth::controlChange(uint8_t data1, uint8_t data2) {
     switch (data1) {
         // Mod Wheel
         case 0x01:
-            params.modWheel = 0.000005f * float(data2 * data2);
+            modWheel = 0.000005f * float(data2 * data2);
             break;
         // Sustain Pedal
         case 0x40:
@@ -288,14 +401,10 @@ void Synth::controlChange(uint8_t data1, uint8_t data2) {
             }
             break;
     }
-    // Resonance
-    if (data1 == resoCC) {
-        resonanceCtrl = 154.0f / float(154 - data2);
-    }
 }
 
 float Synth::calcPeriod(int v, int midiNote) const {
-    float period = params.tune * std::exp(-0.05776226505f * (float(midiNote) + params.ANALOG * float(v)));
+    float period = params.tune * std::exp(-0.05776226505f * (float(midiNote) + RenderParams::ANALOG * float(v)));
     // Keep the period from being too small, or BILT may not work reliably
     // Makes sure period is at least 6 samples,
     while (period < 6.0f || (period * params.detune) < 6.0f) {
@@ -307,8 +416,21 @@ float Synth::calcPeriod(int v, int midiNote) const {
 int Synth::findFreeVoice() const {
     int v = 0;
     float l = 100.0f; // Louder than any envelope!
+    // Over the voice limit, only steal from the voices that are already sounding.  If
+    // they're all in their attack, the first of them goes.  With none sounding, a new
+    // note can always start one
+    const int activeVoices = getActiveVoiceCount();
+    const bool atLimit = voiceLimit < MAX_VOICES && activeVoices > 0 && activeVoices >= voiceLimit;
+    if (atLimit) {
+        while (!voices[v].env.isActive()) {
+            ++v;
+        }
+    }
     
     for (int i = 0; i < MAX_VOICES; ++i) {
+        if (atLimit && !voices[i].env.isActive()) {
+            continue;
+        }
         if (voices[i].env.level < l && !voices[i].env.isInAttackStage()) {
             l = voices[i].env.level;
             v = i;
@@ -13,7 +13,9 @@
 #include <JuceHeader.h>
 #include "Voice.h"
 #include "NoiseGenerator.h"
-#include "Parameters.h"
+#include "RenderParams.h"
+#include "LFO.h"
+#include "SharedResources.h"
 
 // For holding down notes while the sustain pedal is pressed
 static const int SUSTAIN = -1;
@@ -21,7 +23,6 @@ static const int SUSTAIN = -1;
 class Synth {
     public:
         Synth();
-        Parameters params;
         // These two functions are called right before the host starts playoing anduio and after it finishes
         // Think of them like prepareToPlay and releaseResources
         void allocateResources(double sampleRate, int samplesPerBlock);
@@ -29,16 +30,42 @@ class Synth {
         void reset();
         void render(float** outputBuffers,  int sampleCount);
         void midiMessage(uint8_t data0, uint8_t data1, uint8_t data2);
-        uint8_t resoCC = 0x47;
+        // Takes a copy of the parameters for the next render() and note ons.  Call it
+        // between render() calls, never during one
+        void setParams(const RenderParams& newParams);
+        // For the MIDI volume, changes the gain right away (the parameter catches up later)
+        void setOutputLevel(float gain);
+        // Lets every sounding note go into its release, like letting go of the keys
+        void releaseAllVoices();
+        // For the editor's voice display: each voice's note (0 if it's free) and amplitude
+        // envelope level.  Returns how many are sounding.  Call it between render() calls
+        int getVoiceStates(uint8_t* notes, float* envelopeLevels) const;
+        // How many voices are sounding (releases included)
+        int getActiveVoiceCount() const;
+        // In the multi-timbral mode the parts share a voice budget.  Once this many voices
+        // are sounding, a new note takes over one of them instead of starting another
+        void setVoiceLimit(int limit) { voiceLimit = limit; }
     private:
         float sampleRate;
+        // The snapshot everything below reads from, it's never written while rendering
+        RenderParams params {};
         std::array<Voice, MAX_VOICES> voices;
+        int voiceLimit = MAX_VOICES;
+        VoiceSettings voiceSettings;
         NoiseGenerator noiseGen;
+        // The shared noise for the current chunk, already scaled by the noise mix
+        float noiseBlock[BLOCK_SIZE];
+        // Shared with the other instances in the process (see SharedResources.h)
+        std::shared_ptr<const WavetableBank> wavetables;
+        std::shared_ptr<const FilterCoefficientTable> filterTable;
         int lfoStep;
-        float lfo;
+        LFO lfo;
+        float lfoBlock[MAX_UPDATES];
         int lastNote;
+        float pitchBend;
+        float modWheel;
+        juce::LinearSmoothedValue<float> outputLevelSmoother;
         bool sustainPedalPressed;
-        float resonanceCtrl;
         float filterCtrl;
         float aftertouch;
         float filterZip;    // For smoothing filter zipper nosie
@@ -51,10 +78,13 @@ class Synth {
         int findFreeVoice() const;
         void shiftQueuedNotes();
         int nextQueuedNote();
-        void updateLFO();
+        // update is the index into lfoBlock and the voices' filterEnvBlock
+        void updateLFO(int update);
+        void renderVoices(float* outputBufferLeft, float* outputBufferRight, int blockSize);
+        void scaleNoise(float* buffer, int sampleCount) const;
         inline void updatePeriod(Voice& voice) {
-            voice.osc1.period = voice.period * params.pitchBend;
-            voice.osc2.period = voice.osc1.period * params.detune;
+            float period1 = voice.period * pitchBend;
+            voice.setPeriods(period1, period1 * params.detune);
         }
         bool isPlayingLegatoStyle() const;
 };
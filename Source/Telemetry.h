@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    Telemetry.h
+    Created: 20 Oct 2026 1:41:12am
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "Constants.h"
+
+// What the audio thread tells the editor, a copy of it every so often
+struct TelemetryFrame {
+    int activeVoices = 0;
+    // 0 is a free voice
+    uint8_t notes[MAX_VOICES] = {};
+    float envelopeLevels[MAX_VOICES] = {};
+    // The highest sample since the previous frame (gain, not dB)
+    float outputPeak = 0.0f;
+    // How much of the block time processBlock takes, 0 to 1
+    float cpuLoad = 0.0f;
+    // A CC MIDI learn heard since the previous frame, -1 is none
+    int learnedCC = -1;
+};
+
+// A single producer, single consumer queue of frames from the audio thread to the
+// editor.  The frames are copied in and out of a fixed array, so neither side
+// locks or allocates.  When the editor isn't draining it (or isn't open) the audio
+// thread's frames are dropped.
+class Telemetry {
+    public:
+        // Holds CAPACITY - 1 frames, a few seconds' worth at the frame rate
+        static constexpr int CAPACITY = 128;
+
+        // Audio thread.  Returns false if the queue is full
+        bool push(const TelemetryFrame& frame) {
+            const auto scope = fifo.write(1);
+            if (scope.blockSize1 == 0) {
+                return false;
+            }
+            frames[size_t(scope.startIndex1)] = frame;
+            return true;
+        }
+
+        // Editor.  Returns false if there's nothing new
+        bool pop(TelemetryFrame& frame) {
+            const auto scope = fifo.read(1);
+            if (scope.blockSize1 == 0) {
+                return false;
+            }
+            frame = frames[size_t(scope.startIndex1)];
+            return true;
+        }
+
+        // The editor switches it on while it's open, so the audio thread doesn't
+        // gather frames nobody reads
+        void setActive(bool shouldBeActive) { active.store(shouldBeActive); }
+        bool isActive() const noexcept { return active.load(); }
+
+    private:
+        juce::AbstractFifo fifo { CAPACITY };
+        std::array<TelemetryFrame, CAPACITY> frames;
+        std::atomic<bool> active { false };
+};
@@ -0,0 +1,306 @@
+/*
+  ==============================================================================
+
+    UserPresetBank.cpp
+    Created: 19 Oct 2026 10:58:44pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#include "UserPresetBank.h"
+
+juce::File UserPresetBank::getDefaultFile() {
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("JX11")
+        .getChildFile("User Presets.jx11bank");
+}
+
+bool UserPresetBank::open(const juce::File& file) {
+    bankFile = file;
+    {
+        // Two instances creating it at once would both write a header
+        const juce::InterProcessLock::ScopedLockType fileLock(writeLock);
+        if (!bankFile.existsAsFile()) {
+            if (!fileLock.isLocked() || !bankFile.getParentDirectory().createDirectory()) {
+                return false;
+            }
+            juce::FileOutputStream stream(bankFile);
+            if (!stream.openedOk()) {
+                return false;
+            }
+            stream.writeInt(int(MAGIC));
+            stream.writeInt(int(VERSION));
+            stream.writeInt(int(sizeof(Record)));
+            stream.writeInt(0);
+        }
+    }
+    const juce::ScopedLock scopedLock(lock);
+    if (!map()) {
+        return false;
+    }
+    buildIndex();
+    return true;
+}
+
+bool UserPresetBank::refresh() {
+    if (!isOpen() || !fileChanged()) {
+        return false;
+    }
+    const juce::ScopedLock scopedLock(lock);
+    map();
+    buildIndex();
+    return true;
+}
+
+bool UserPresetBank::fileChanged() const {
+    return bankFile.getSize() != mappedSize || bankFile.getLastModificationTime() != mappedTime;
+}
+
+bool UserPresetBank::map() {
+   #if JUCE_WINDOWS
+    // Mapped for writing so the file is shared for writing, see writeAt
+    constexpr auto mode = juce::MemoryMappedFile::readWrite;
+   #else
+    constexpr auto mode = juce::MemoryMappedFile::readOnly;
+   #endif
+    mappedSize = bankFile.getSize();
+    mappedTime = bankFile.getLastModificationTime();
+    mappedFile = std::make_unique<juce::MemoryMappedFile>(bankFile, mode);
+    records = nullptr;
+    count = 0;
+    if (mappedFile->getData() == nullptr || mappedFile->getSize() < size_t(HEADER_SIZE)) {
+        mappedFile.reset();
+        return false;
+    }
+    const uint32_t* header = static_cast<const uint32_t*>(mappedFile->getData());
+    if (header[0] != MAGIC || header[1] > VERSION || header[2] != sizeof(Record)) {
+        // Not a bank, or one from a newer version with a different record layout
+        jassertfalse;
+        mappedFile.reset();
+        return false;
+    }
+    records = reinterpret_cast<const Record*>(static_cast<const char*>(mappedFile->getData()) + HEADER_SIZE);
+    // Don't trust the count past the end of the file
+    int recordsInFile = int((mappedFile->getSize() - size_t(HEADER_SIZE)) / sizeof(Record));
+    count = std::min(int(header[3]), recordsInFile);
+    return true;
+}
+
+// Searches only use the index, it's built here and then kept up to date by append
+// and rename
+void UserPresetBank::buildIndex() {
+    wordIndex.clear();
+    categoryIndex.clear();
+    categories.clear();
+    for (int i = 0; i < count; ++i) {
+        addToIndex(i, false);
+    }
+    std::sort(wordIndex.begin(), wordIndex.end());
+}
+
+// Remaps the file for a write, under writeLock.  The index is rebuilt if somebody
+// else has written to the file since it was last mapped
+bool UserPresetBank::remapForWrite() {
+    const int indexed = count;
+    const bool changed = fileChanged();
+    if (!map()) {
+        return false;
+    }
+    if (changed || count != indexed) {
+        buildIndex();
+    }
+    return true;
+}
+
+// On Windows a FileOutputStream can't open the file while another process has it
+// mapped.  Mapping it again works, and mapping past the end grows the file there
+bool UserPresetBank::writeAt(juce::int64 position, const void* data, size_t size) {
+   #if JUCE_WINDOWS
+    juce::MemoryMappedFile region(bankFile, { position, position + juce::int64(size) }, juce::MemoryMappedFile::readWrite);
+    if (region.getData() == nullptr) {
+        return false;
+    }
+    // The mapping starts on a page boundary
+    std::memcpy(static_cast<char*>(region.getData()) + (position - region.getRange().getStart()), data, size);
+    return true;
+   #else
+    juce::FileOutputStream stream(bankFile);
+    return stream.openedOk() && stream.setPosition(position) && stream.write(data, size);
+   #endif
+}
+
+const UserPresetBank::Record& UserPresetBank::record(int index) const {
+    jassert(index >= 0 && index < count);
+    return records[index];
+}
+
+juce::String UserPresetBank::getName(int index) const {
+    return readField(record(index).name, NAME_SIZE);
+}
+
+juce::String UserPresetBank::getCategory(int index) const {
+    return readField(record(index).category, CATEGORY_SIZE);
+}
+
+int UserPresetBank::append(const juce::String& name, const juce::String& category, const float* param) {
+    if (!isOpen()) {
+        return -1;
+    }
+    Record newRecord {};
+    writeField(newRecord.name, NAME_SIZE, name);
+    writeField(newRecord.category, CATEGORY_SIZE, category);
+    std::copy(param, param + NUM_PARAMS, newRecord.param);
+
+    const juce::InterProcessLock::ScopedLockType fileLock(writeLock);
+    const juce::ScopedLock scopedLock(lock);
+    // The slot is the count in the file, another instance might have appended since
+    // this one mapped it
+    if (!fileLock.isLocked() || !remapForWrite()) {
+        return -1;
+    }
+    const int index = count;
+    // The record first, then the count.  Anything after the last counted record
+    // (from an earlier failed save) is overwritten
+    const uint32_t newCount = uint32_t(index + 1);
+    const bool written = writeAt(juce::int64(HEADER_SIZE) + juce::int64(index) * juce::int64(sizeof(Record)),
+                                 &newRecord, sizeof(Record))
+                         && writeAt(12, &newCount, sizeof(newCount));
+    if (!map() || !written) {
+        return -1;
+    }
+    addToIndex(index, true);
+    return index;
+}
+
+bool UserPresetBank::rename(int index, const juce::String& newName) {
+    if (!isOpen() || index < 0 || index >= count) {
+        return false;
+    }
+    char field[NAME_SIZE];
+    writeField(field, NAME_SIZE, newName);
+    const juce::InterProcessLock::ScopedLockType fileLock(writeLock);
+    const juce::ScopedLock scopedLock(lock);
+    if (!fileLock.isLocked() || !remapForWrite()) {
+        return false;
+    }
+    // Read before the mapping goes away
+    const juce::StringArray oldWords = wordsOf(getName(index));
+    const bool written = writeAt(juce::int64(HEADER_SIZE) + juce::int64(index) * juce::int64(sizeof(Record)),
+                                 field, NAME_SIZE);
+    if (!map() || !written) {
+        return false;
+    }
+    // Swap the old name's words in the index for the new ones
+    for (const auto& word : oldWords) {
+        auto range = std::equal_range(wordIndex.begin(), wordIndex.end(), WordEntry { word, index });
+        auto found = std::find_if(range.first, range.second, [index](const WordEntry& entry) {
+            return entry.index == index;
+        });
+        if (found != range.second) {
+            wordIndex.erase(found);
+        }
+    }
+    for (const auto& word : wordsOf(getName(index))) {
+        WordEntry entry { word, index };
+        wordIndex.insert(std::upper_bound(wordIndex.begin(), wordIndex.end(), entry), entry);
+    }
+    return true;
+}
+
+juce::Array<int> UserPresetBank::search(const juce::String& text, const juce::String& category) const {
+    juce::Array<int> results;
+    const juce::StringArray words = wordsOf(text);
+    auto inCategory = [&](int index) {
+        return category.isEmpty() || getCategory(index) == category;
+    };
+
+    if (words.isEmpty()) {
+        if (category.isEmpty()) {
+            for (int i = 0; i < count; ++i) {
+                results.add(i);
+            }
+        } else {
+            auto found = categoryIndex.find(category);
+            if (found != categoryIndex.end()) {
+                results = found->second;
+            }
+        }
+        return results;
+    }
+
+    // All the words in the index that start with the first word are next to each other
+    const juce::String& first = words[0];
+    auto it = std::lower_bound(wordIndex.begin(), wordIndex.end(), WordEntry { first, 0 });
+    juce::Array<int> candidates;
+    for (; it != wordIndex.end() && it->word.startsWith(first); ++it) {
+        candidates.addIfNotAlreadyThere(it->index);
+    }
+    candidates.sort();
+
+    for (int index : candidates) {
+        if (!inCategory(index)) {
+            continue;
+        }
+        const juce::StringArray nameWords = wordsOf(getName(index));
+        bool matches = true;
+        for (const auto& word : words) {
+            bool found = false;
+            for (const auto& nameWord : nameWords) {
+                if (nameWord.startsWith(word)) {
+                    found = true;
+                    break;
+                }
+            }
+            matches = matches && found;
+        }
+        if (matches) {
+            results.add(index);
+        }
+    }
+    return results;
+}
+
+void UserPresetBank::addToIndex(int index, bool keepSorted) {
+    for (const auto& word : wordsOf(getName(index))) {
+        WordEntry entry { word, index };
+        if (keepSorted) {
+            wordIndex.insert(std::upper_bound(wordIndex.begin(), wordIndex.end(), entry), entry);
+        } else {
+            wordIndex.push_back(entry);
+        }
+    }
+    juce::String category = getCategory(index);
+    if (category.isNotEmpty()) {
+        auto& members = categoryIndex[category];
+        if (members.isEmpty()) {
+            categories.add(category);
+            categories.sort(true);
+        }
+        members.add(index);
+    }
+}
+
+juce::StringArray UserPresetBank::wordsOf(const juce::String& text) {
+    juce::StringArray words = juce::StringArray::fromTokens(text.toLowerCase(), " -_()[]/.,", "");
+    words.removeEmptyStrings();
+    return words;
+}
+
+juce::String UserPresetBank::readField(const char* field, int size) {
+    int length = 0;
+    while (length < size && field[length] != 0) {
+        ++length;
+    }
+    return juce::String::fromUTF8(field, length);
+}
+
+void UserPresetBank::writeField(char* field, int size, const juce::String& text) {
+    std::fill(field, field + size, 0);
+    // Leave room for the terminator, and don't cut a UTF-8 character in half
+    juce::String trimmed = text;
+    while (int(trimmed.getNumBytesAsUTF8()) > size - 1) {
+        trimmed = trimmed.dropLastCharacters(1);
+    }
+    trimmed.copyToUTF8(field, size_t(size));
+}
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    UserPresetBank.h
+    Created: 19 Oct 2026 10:58:44pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Preset.h"
+
+// The user preset library: one bank file with fixed size records, memory mapped.
+//
+//   header:  'JXPB' magic, uint32 version, uint32 record size, uint32 record count
+//   records: Record, one after the other
+//
+// A preset is read straight out of the mapping by index, there's nothing to parse.
+// Saving appends a record and then bumps the count, so the file is never rewritten
+// (and a crash in between only loses the new preset).  The floats are stored in the
+// machine's byte order, which is little endian on everything we build for.
+//
+// Other instances, in this process or another one, can write to the same file.  The
+// writes are done under an InterProcessLock, with the count read from the file, and
+// refresh() picks up somebody else's changes.
+//
+// Changed on the message thread only.  Other threads can read it while they hold
+// getLock(), which is held while the mapping changes.  Don't hold on to Record pointers.
+class UserPresetBank {
+    public:
+        static constexpr int NAME_SIZE = 40;
+        static constexpr int CATEGORY_SIZE = 24;
+
+        struct Record {
+            char name[NAME_SIZE];           // UTF-8, zero padded
+            char category[CATEGORY_SIZE];
+            float param[NUM_PARAMS];        // In Preset order
+            uint32_t reserved;
+        };
+
+        // The default bank, in the user's application data folder
+        static juce::File getDefaultFile();
+
+        // Creates the file if it doesn't exist yet
+        bool open(const juce::File& file);
+        bool isOpen() const noexcept { return mappedFile != nullptr; }
+
+        // Remaps the file and rebuilds the index if another instance changed it.  Returns
+        // true if it did
+        bool refresh();
+        const juce::CriticalSection& getLock() const noexcept { return lock; }
+
+        int size() const noexcept { return count.load(); }
+        const Record& record(int index) const;
+        juce::String getName(int index) const;
+        juce::String getCategory(int index) const;
+
+        // Returns the new preset's index, or -1 if it couldn't be written
+        int append(const juce::String& name, const juce::String& category, const float* param);
+        // Overwrites the name in place
+        bool rename(int index, const juce::String& newName);
+
+        // Presets with a word in the name starting with each word of text, in the category
+        // (empty text or category matches everything).  Uses the index, so only the presets
+        // that match the first word are looked at
+        juce::Array<int> search(const juce::String& text, const juce::String& category) const;
+        const juce::StringArray& getCategories() const noexcept { return categories; }
+
+    private:
+        static constexpr uint32_t MAGIC = 0x4250584A;   // "JXPB", little endian
+        static constexpr uint32_t VERSION = 1;
+        static constexpr int HEADER_SIZE = 16;
+
+        juce::File bankFile;
+        std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+        const Record* records = nullptr;
+        // Read by the host's getNumPrograms without the lock
+        std::atomic<int> count { 0 };
+        // What the file looked like when it was mapped, to tell if it has changed since
+        juce::int64 mappedSize = 0;
+        juce::Time mappedTime;
+        juce::CriticalSection lock;
+        juce::InterProcessLock writeLock { "JX11 User Presets" };
+
+        // Every word of every name, lower case and sorted, with the preset it's from
+        struct WordEntry {
+            juce::String word;
+            int index;
+            bool operator<(const WordEntry& other) const {
+                return word < other.word;
+            }
+        };
+        std::vector<WordEntry> wordIndex;
+        std::map<juce::String, juce::Array<int>> categoryIndex;
+        juce::StringArray categories;
+
+        bool fileChanged() const;
+        bool map();
+        void buildIndex();
+        bool remapForWrite();
+        bool writeAt(juce::int64 position, const void* data, size_t size);
+        // keepSorted is false while open builds the whole index (it sorts once at the end)
+        void addToIndex(int index, bool keepSorted);
+        static juce::StringArray wordsOf(const juce::String& text);
+        static juce::String readField(const char* field, int size);
+        static void writeField(char* field, int size, const juce::String& text);
+};
+
+static_assert(sizeof(UserPresetBank::Record) == 192, "The record layout is part of the file format");
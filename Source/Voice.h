@@ -10,26 +10,109 @@
 #pragma once
 
 #include "Oscillator.h"
+#include "PolyBLEPOscillator.h"
+#include "WavetableOscillator.h"
+#include "BlitTableOscillator.h"
 #include "Envelope.h"
 #include "Filter.h"
+#include "LadderFilter.h"
+#include "Oversampler.h"
+#include "NoiseGenerator.h"
 
-struct Voice {
-  
-    int note;
+// The filter is oversampled once the cutoff goes above this fraction of the sample rate,
+// or the Q goes above OVERSAMPLE_Q.  Both have to fall 20% below before it switches back.
+static constexpr float OVERSAMPLE_CUTOFF = 0.2f;
+static constexpr float OVERSAMPLE_Q = 8.0f;
+static constexpr float OVERSAMPLE_HYSTERESIS = 0.8f;
+// A switch runs the new path for two chunks before fading over to it across the next one,
+// so the half-band filters are full of real samples and the filter state has caught up
+// with the new path's latency by the time it's heard
+static constexpr int OVERSAMPLE_WARM_UP = 2 * BLOCK_SIZE;
+static constexpr int OVERSAMPLE_FADE = BLOCK_SIZE;
+// Holds the 1x path's output for the oversampled paths' latency (19 or 29 samples)
+static constexpr int BYPASS_DELAY_SIZE = 32;
+// The same limits in log2, for the coefficient table
+static constexpr float LOG2_E = 1.4426950408889634f;
+static constexpr float LOG2_MIN_CUTOFF = 4.9068905956085187f;      // log2(30)
+static constexpr float LOG2_MAX_CUTOFF = 14.287712379549449f;      // log2(20000)
+static constexpr float LOG2_OVERSAMPLE_CUTOFF = -2.3219280948873622f;     // log2(0.2)
+static constexpr float LOG2_OVERSAMPLE_CUTOFF_LOW = -2.6438561897747247f; // log2(0.2 * 0.8)
+
+// Settings that are the same for every voice.  Synth fills in one of these per block
+// (filterMod per modulation update) and passes it to the voices, instead of copying
+// the values into every voice
+struct VoiceSettings {
+    int oscEngine = OSC_BLIT;
+    int filterType = FILTER_SVF_LP;
+    int maxOversampling = 1;    // From the Filter Oversampling parameter: 1, 2 or 4
+    float glideRate = 1.0f;
+    float filterQ = 1.0f;
+    float pitchBend = 1.0f;
+    float filterEnvDepth = 0.0f;
+    float filterMod = 0.0f;
+    // When this is set the filter coefficients come from the table, and the log2 values are used
+    const FilterCoefficientTable* coefficientTable = nullptr;
+    float log2FilterQ = 0.0f;
+    float filterK = 1.0f;       // 1 / filterQ, for the SVF
+    float log2PitchBend = 0.0f;
+    float log2SampleRate = 0.0f;
+};
+
+// The scalar state render touches on every sample with the default engine and filter
+// (BLIT and SVF, no oversampling) fills exactly the first two cache lines.  The envelope
+// buffer starts the third: it's read one float per sample, so that's one more line every
+// 16 samples.  The other engines and filters, the oversampling and the per-note settings
+// come after.
+struct alignas(64) Voice {
+    // Hot: read or written on every sample
+    // Set at the start of each chunk, the voice renders the whole chunk if it's active
+    bool active = false;
+    uint8_t filterType = FILTER_SVF_LP;
+    // The filter runs at 1x with no delay and no switch going on, so renderFilter only
+    // needs the model
+    bool plainFilter = true;
     float saw;
+    float panLeft, panRight;
+    Oscillator osc1, osc2;
+    Filter filter;
+    // The amplitude envelope for the current chunk
+    float envBlock[BLOCK_SIZE];
+    
+    // Warm: only for some engines, filters and settings
+    // Only used when each voice has its own noise (the Noise Spread parameter)
+    float noiseBlock[BLOCK_SIZE];
+    LadderFilter ladder;
+    PolyBLEPOscillator blep1, blep2;
+    WavetableOscillator wave1, wave2;
+    BlitTableOscillator blitTable1, blitTable2;
+    // What the filter oversampling is actually using right now (1, 2 or 4)
+    uint8_t oversampling = 1;
+    // While switching, the path being switched away from keeps running on a copy of the
+    // filter.  fadeSamples counts down the warm up and then the fade
+    uint8_t fadeFrom = 1;
+    uint8_t fadeSamples = 0;
+    HalfBandStage stage1, stage2;
+    // At 4x the 2x stream is held back one sample, which makes the latency 29 samples
+    // instead of 28.5
+    float stage2Delay;
+    // With oversampling on, the 1x path is delayed to line up with the 2x and 4x ones
+    float bypassDelay[BYPASS_DELAY_SIZE];
+    int bypassPos;
+    int bypassLatency;
+    Filter fadeFilter;
+    LadderFilter fadeLadder;
+    
+    // Cold: changed per note or per modulation update
+    int note;
     float period;
     float targetPeriod;
-    float glideRate;
-    float panLeft, panRight;
     float cutoff;
-    float filterQ;
+    float log2Cutoff;
     Envelope env;
-    Oscillator osc1, osc2;
-    Filter filter;
     Envelope filterEnv;
-    float filterEnvDepth;
-    float filterMod;
-    float pitchBend;
+    // The filter envelope for the next few modulation updates
+    float filterEnvBlock[MAX_UPDATES];
+    NoiseGenerator noiseGen;
     
     void reset() {
         note = 0;
@@ -38,23 +121,64 @@ struct Voice {
         panRight = 0.707f;
         osc1.reset();
         osc2.reset();
+        blep1.reset();
+        blep2.reset();
+        wave1.reset();
+        wave2.reset();
+        blitTable1.reset();
+        blitTable2.reset();
         env.reset();
+        active = false;
         filter.reset();
+        ladder.reset();
         filterEnv.reset();
+        plainFilter = true;
+        oversampling = 1;
+        stage1.reset();
+        stage2.reset();
+        stage2Delay = 0.0f;
+        std::fill(bypassDelay, bypassDelay + BYPASS_DELAY_SIZE, 0.0f);
+        bypassPos = 0;
+        bypassLatency = 0;
+        fadeSamples = 0;
+        fadeFrom = 1;
+    }
+    
+    void renderEnvelope(int sampleCount) {
+        env.renderBlock(envBlock, sampleCount);
     }
     
-    float render(float input) {
-        float sample1 = osc1.nextSample();
-        float sample2 = osc2.nextSample();
-        // Multiplication by 0.997 is a "leaky" integrator and acts as a simple lowpass filter
-        // Plus or minus here is a phase inversion:
-        saw = (saw * 0.997f) + (sample1 - sample2);
-        float output = saw + input;
+    // sample is the position in the current chunk
+    float render(const VoiceSettings& settings, float input, int sample) {
+        float oscOutput;
+        switch (settings.oscEngine) {
+            case OSC_POLYBLEP:
+                // These already output a saw, so there's nothing to integrate
+                oscOutput = blep1.nextSample() - blep2.nextSample();
+                break;
+            case OSC_WAVETABLE:
+                oscOutput = wave1.nextSample() - wave2.nextSample();
+                break;
+            case OSC_BLIT_TABLE:
+                // Impulses like the BLIT, so it goes through the same leaky integrator
+                saw = (saw * 0.997f) + (blitTable1.nextSample() - blitTable2.nextSample());
+                oscOutput = saw;
+                break;
+            default: {
+                float sample1 = osc1.nextSample();
+                float sample2 = osc2.nextSample();
+                // Multiplication by 0.997 is a "leaky" integrator and acts as a simple lowpass filter
+                // Plus or minus here is a phase inversion:
+                saw = (saw * 0.997f) + (sample1 - sample2);
+                oscOutput = saw;
+                break;
+            }
+        }
+        float output = oscOutput + input;
         // Apply the filter
-        output = filter.render(output);
+        output = renderFilter(output);
         // Apply the envelope
-        float envValue = env.nextValue();
-        return output * envValue;
+        return output * envBlock[sample];
     }
     
     void release() {
@@ -62,19 +186,205 @@ struct Voice {
         filterEnv.release();
     }
     
+    // These set every engine, so switching engines in the middle of a note is safe
+    void setPeriods(float period1, float period2) {
+        osc1.period = period1;
+        osc2.period = period2;
+        blep1.period = period1;
+        blep2.period = period2;
+        wave1.period = period1;
+        wave2.period = period2;
+        blitTable1.period = period1;
+        blitTable2.period = period2;
+    }
+    
+    void setAmplitudes(float amplitude1, float amplitude2) {
+        osc1.amplitude = amplitude1;
+        osc2.amplitude = amplitude2;
+        blep1.amplitude = amplitude1;
+        blep2.amplitude = amplitude2;
+        wave1.amplitude = amplitude1;
+        wave2.amplitude = amplitude2;
+        blitTable1.amplitude = amplitude1;
+        blitTable2.amplitude = amplitude2;
+    }
+    
+    void setPitchModulation(float vibratoMod, float pwm) {
+        osc1.pitchModulation = vibratoMod;
+        osc2.pitchModulation = pwm;
+        blep1.pitchModulation = vibratoMod;
+        blep2.pitchModulation = pwm;
+        wave1.pitchModulation = vibratoMod;
+        wave2.pitchModulation = pwm;
+        blitTable1.pitchModulation = vibratoMod;
+        blitTable2.pitchModulation = pwm;
+    }
+    
+    void setWavetables(const WavetableBank* bank) {
+        wave1.bank = bank;
+        wave2.bank = bank;
+    }
+    
+    // Phase locks oscillator 2 to oscillator 1 for PWM
+    void squareWave(float newPeriod) {
+        osc2.squareWave(osc1, newPeriod);
+        blep2.squareWave(blep1, newPeriod);
+        wave2.squareWave(wave1, newPeriod);
+        blitTable2.squareWave(blitTable1, newPeriod);
+    }
+    
+    void setFilterType(int newType) {
+        filterType = uint8_t(newType);
+        ladder.nonlinear = (newType == FILTER_LADDER_DRIVE);
+    }
+    
+    inline float renderFilterModel(Filter& svf, LadderFilter& ladderModel, float input) {
+        return filterType >= FILTER_LADDER ? ladderModel.render(input) : svf.render(input, filterType);
+    }
+    
+    // Only the model that's in use gets its coefficients updated
+    inline void updateFilterCoefficients(float modulatedCutoff, float Q) {
+        if (filterType >= FILTER_LADDER) {
+            ladder.updateCoefficients(modulatedCutoff, Q);
+        } else {
+            filter.updateCoefficients(modulatedCutoff, Q);
+        }
+    }
+    
+    inline void updateFilterCoefficients(const VoiceSettings& settings, float log2ModulatedCutoff) {
+        const FilterCoefficientTable& table = *settings.coefficientTable;
+        if (filterType >= FILTER_LADDER) {
+            ladder.updateCoefficients(table, log2ModulatedCutoff, settings.filterQ);
+        } else {
+            filter.updateCoefficients(table, log2ModulatedCutoff, settings.log2FilterQ, settings.filterK);
+        }
+    }
+    
+    // Runs the filter at 1x, 2x or 4x the sample rate, going through the half-band stages
+    inline float renderFilterPath(float input, int factor, Filter& svf, LadderFilter& ladderModel) {
+        if (factor == 1) {
+            float output = renderFilterModel(svf, ladderModel, input);
+            if (bypassLatency == 0) {
+                return output;
+            }
+            bypassDelay[bypassPos] = output;
+            output = bypassDelay[(bypassPos - bypassLatency) & (BYPASS_DELAY_SIZE - 1)];
+            bypassPos = (bypassPos + 1) & (BYPASS_DELAY_SIZE - 1);
+            return output;
+        } else if (factor == 2) {
+            float up0, up1;
+            stage1.upsample(input, up0, up1);
+            return stage1.downsample(renderFilterModel(svf, ladderModel, up0), renderFilterModel(svf, ladderModel, up1));
+        }
+        float up0, up1, a0, a1, b0, b1;
+        stage1.upsample(input, up0, up1);
+        stage2.upsample(up0, a0, a1);
+        stage2.upsample(up1, b0, b1);
+        float down0 = stage2.downsample(renderFilterModel(svf, ladderModel, a0), renderFilterModel(svf, ladderModel, a1));
+        float down1 = stage2.downsample(renderFilterModel(svf, ladderModel, b0), renderFilterModel(svf, ladderModel, b1));
+        float output = stage1.downsample(stage2Delay, down0);
+        stage2Delay = down1;
+        return output;
+    }
+
+    inline float renderFilter(float input) {
+        if (plainFilter) {
+            return renderFilterModel(filter, ladder, input);
+        }
+        const float output = renderFilterPath(input, oversampling, filter, ladder);
+        return fadeSamples > 0 ? fadeFilterPaths(input, output) : output;
+    }
+
+    // Between 1x and 2x or 4x the two paths don't share anything (one of them uses the
+    // bypass delay, the other the half-band stages), so both can run at once
+    float fadeFilterPaths(float input, float newOutput) {
+        const float oldOutput = renderFilterPath(input, fadeFrom, fadeFilter, fadeLadder);
+        if (--fadeSamples == 0) {
+            plainFilter = oversampling == 1 && bypassLatency == 0;
+        }
+        if (fadeSamples >= OVERSAMPLE_FADE) {
+            return oldOutput;
+        }
+        const float mix = float(OVERSAMPLE_FADE - fadeSamples) / float(OVERSAMPLE_FADE);
+        return oldOutput + mix * (newOutput - oldOutput);
+    }
+    
+    // Only pay for the oversampling when the filter is bright or resonant enough to alias.
+    // bright and dark say whether the cutoff is above the threshold, or below it with the hysteresis
+    void updateOversampling(const VoiceSettings& settings, bool bright, bool dark) {
+        int wanted = oversampling;
+        if (settings.maxOversampling == 1) {
+            wanted = 1;
+        } else if (bright || settings.filterQ > OVERSAMPLE_Q) {
+            wanted = settings.maxOversampling;
+        } else if (dark && settings.filterQ < OVERSAMPLE_Q * OVERSAMPLE_HYSTERESIS) {
+            wanted = 1;
+        } else if (oversampling > 1) {
+            // In between the thresholds, but the parameter may have changed
+            wanted = settings.maxOversampling;
+        }
+        // The delay that lines the 1x path up with the oversampled one.  It only changes
+        // with the parameter, and then it starts out holding the newest sample it had
+        const int latency = settings.maxOversampling == 4 ? HalfBandStage::LATENCY + (HalfBandStage::LATENCY + 1) / 2
+                          : settings.maxOversampling == 2 ? HalfBandStage::LATENCY : 0;
+        if (latency != bypassLatency) {
+            const float newest = bypassLatency > 0 ? bypassDelay[(bypassPos - 1) & (BYPASS_DELAY_SIZE - 1)] : 0.0f;
+            std::fill(bypassDelay, bypassDelay + BYPASS_DELAY_SIZE, newest);
+            bypassLatency = latency;
+        }
+        // A fade in progress is finished first.  The new path's stages don't need clearing,
+        // the warm up fills them
+        if (wanted != oversampling && fadeSamples == 0) {
+            if (wanted == 1 || oversampling == 1) {
+                // The old path carries on with a copy of the filter as it is now, the new
+                // coefficients only go into the real one
+                fadeFilter = filter;
+                fadeLadder = ladder;
+                fadeFrom = oversampling;
+                fadeSamples = OVERSAMPLE_WARM_UP + OVERSAMPLE_FADE;
+            }
+            // Between 2x and 4x (only when the parameter changes) the paths share the
+            // first stage, so that one just switches
+            oversampling = uint8_t(wanted);
+        }
+        plainFilter = oversampling == 1 && bypassLatency == 0 && fadeSamples == 0;
+    }
+    
     void updatePanning() {
         float panning = std::clamp((note - 60.0f) / 24.0f, -1.0f, 1.0f);
         panLeft = std::sin(PI_OVER_4 * (1.0f - panning));
         panRight = std::sin(PI_OVER_4 * (1.0f + panning));
     }
     
-    void updateLFO() {
-        period += glideRate * (targetPeriod - period);
+    void setCutoff(float newCutoff) {
+        cutoff = newCutoff;
+        log2Cutoff = std::log2(newCutoff);
+    }
+    
+    // Called once every LFO_MAX samples, update is the index into filterEnvBlock
+    void updateLFO(const VoiceSettings& settings, int update) {
+        if (settings.filterType != filterType) {
+            setFilterType(settings.filterType);
+        }
+        period += settings.glideRate * (targetPeriod - period);
         // For the filter envelope
-        float fenv = filterEnv.nextValue();
-        // Use the exp because frequencies are logrithmic
-        float modulatedCutoff = cutoff * std::exp(filterMod + filterEnvDepth * fenv) / pitchBend;
-        modulatedCutoff = std::clamp(modulatedCutoff, 30.0f, 20000.0f);
-        filter.updateCoefficients(modulatedCutoff, filterQ);
+        float fenv = filterEnvBlock[update];
+        float modulation = settings.filterMod + settings.filterEnvDepth * fenv;
+        if (settings.coefficientTable != nullptr) {
+            // The same as below but in log2, so there's no exp or tan
+            float modulatedCutoff = log2Cutoff + LOG2_E * modulation - settings.log2PitchBend;
+            modulatedCutoff = std::clamp(modulatedCutoff, LOG2_MIN_CUTOFF, LOG2_MAX_CUTOFF);
+            float cutoffRatio = modulatedCutoff - settings.log2SampleRate;
+            updateOversampling(settings, cutoffRatio > LOG2_OVERSAMPLE_CUTOFF, cutoffRatio < LOG2_OVERSAMPLE_CUTOFF_LOW);
+            updateFilterCoefficients(settings, modulatedCutoff - float(oversampling >> 1));
+        } else {
+            // Use the exp because frequencies are logrithmic
+            float modulatedCutoff = cutoff * std::exp(modulation) / settings.pitchBend;
+            modulatedCutoff = std::clamp(modulatedCutoff, 30.0f, 20000.0f);
+            float cutoffRatio = modulatedCutoff / filter.sampleRate;
+            updateOversampling(settings, cutoffRatio > OVERSAMPLE_CUTOFF, cutoffRatio < OVERSAMPLE_CUTOFF * OVERSAMPLE_HYSTERESIS);
+            // At 2x or 4x the same cutoff is a smaller fraction of the sample rate
+            updateFilterCoefficients(modulatedCutoff / float(oversampling), settings.filterQ);
+        }
     }
 };
@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    WavetableOscillator.h
+    Created: 19 Oct 2026 1:40:52pm
+    Author:  Paul Mayer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include "Constants.h"
+
+// One band limited sawtooth per octave.  Table t only holds harmonics up to
+// (TABLE_SIZE / 2) >> t, so it can be played back with any period of at least
+// TABLE_SIZE >> t samples without anything folding back over Nyquist.  Because the
+// limit is in samples per cycle the tables don't depend on the sample rate.
+class WavetableBank {
+    public:
+        static constexpr int TABLE_SIZE = 2048;
+        static constexpr int NUM_TABLES = 11;
+    
+        // Not real-time safe, call from allocateResources. About 2 million multiply-adds.
+        void build() {
+            if (!tables.empty()) {
+                return;
+            }
+            // One extra sample at the end so the interpolation never needs to wrap
+            tables.assign(size_t(NUM_TABLES * (TABLE_SIZE + 1)), 0.0f);
+            
+            // Each sample's harmonics are generated with the sine recurrence, and the tables are
+            // filled from the fewest harmonics (highest table) to the most, adding as we go
+            std::vector<double> acc(TABLE_SIZE, 0.0), sin0(TABLE_SIZE), sin1(TABLE_SIZE, 0.0), dsin(TABLE_SIZE);
+            for (int n = 0; n < TABLE_SIZE; ++n) {
+                double theta = double(TWO_PI) * double(n) / double(TABLE_SIZE);
+                sin0[size_t(n)] = std::sin(theta);
+                dsin[size_t(n)] = 2.0 * std::cos(theta);
+            }
+            int harmonic = 1;
+            for (int t = NUM_TABLES - 1; t >= 0; --t) {
+                int maxHarmonic = (TABLE_SIZE / 2) >> t;
+                for (; harmonic <= maxHarmonic; ++harmonic) {
+                    // 0.5 - x = sum of sin(2 pi k x) / (pi k)
+                    double gain = 1.0 / (double(PI) * double(harmonic));
+                    for (int n = 0; n < TABLE_SIZE; ++n) {
+                        size_t i = size_t(n);
+                        acc[i] += gain * sin0[i];
+                        double next = dsin[i] * sin0[i] - sin1[i];
+                        sin1[i] = sin0[i];
+                        sin0[i] = next;
+                    }
+                }
+                float* table = &tables[size_t(t * (TABLE_SIZE + 1))];
+                for (int n = 0; n < TABLE_SIZE; ++n) {
+                    table[n] = float(acc[size_t(n)]);
+                }
+                table[TABLE_SIZE] = table[0];
+            }
+        }
+    
+        bool isBuilt() const noexcept {
+            return !tables.empty();
+        }
+    
+        // Picks the richest table that won't alias at this period (in samples)
+        const float* tableForPeriod(float period) const noexcept {
+            int t = 0;
+            float harmonics = float(TABLE_SIZE / 2);
+            while (harmonics > 0.5f * period && t < NUM_TABLES - 1) {
+                harmonics *= 0.5f;
+                ++t;
+            }
+            return &tables[size_t(t * (TABLE_SIZE + 1))];
+        }
+    
+    private:
+        std::vector<float> tables;
+};
+
+// Plays the band limited saw tables.  Same interface as the BLIT Oscillator and, like the
+// PolyBLEPOscillator, outputs the saw directly.  Costs one table lookup per sample, and the
+// table is only chosen once per cycle.
+class WavetableOscillator {
+    public:
+        float period = 0.0f;
+        float amplitude = 1.0f;
+        float pitchModulation = 1.0f;
+        const WavetableBank* bank = nullptr;
+    
+    void reset() {
+        phase = 1.0f;
+        inc = 0.0f;
+        table = nullptr;
+    }
+    
+    float nextSample() {
+        phase += inc;
+        if (phase >= 1.0f) {
+            phase -= 1.0f;
+            float cyclePeriod = period * pitchModulation;
+            inc = 1.0f / cyclePeriod;
+            table = bank->tableForPeriod(cyclePeriod);
+            if (phase >= 1.0f) {
+                phase = 0.0f;
+            }
+        }
+        float pos = phase * float(WavetableBank::TABLE_SIZE);
+        int i = int(pos);
+        float frac = pos - float(i);
+        return amplitude * (table[i] + frac * (table[i + 1] - table[i]));
+    }
+    
+    // Phase locks this oscillator half a cycle away from the other one (for PWM)
+    void squareWave(WavetableOscillator& other, float newPeriod) {
+        if (other.inc > 0.0f) {
+            phase = other.phase + 0.5f;
+            if (phase >= 1.0f) {
+                phase -= 1.0f;
+            }
+            inc = other.inc;
+            table = other.table;
+        } else {
+            // The other oscillator hasn't started yet
+            phase = 0.5f;
+            inc = 1.0f / newPeriod;
+            table = bank->tableForPeriod(newPeriod);
+        }
+    }
+    
+    private:
+        float phase = 1.0f;
+        float inc = 0.0f;
+        const float* table = nullptr;
+};